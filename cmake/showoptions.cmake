@@ -60,6 +60,18 @@ else()
   message(STATUS "Build extractors      : No  (default)")
 endif()
 
+if(BUILD_LOADTEST)
+  message(STATUS "Build load test client: Yes")
+else()
+  message(STATUS "Build load test client: No  (default)")
+endif()
+
+if(BUILD_BENCHMARK)
+  message(STATUS "Build micro benchmarks: Yes")
+else()
+  message(STATUS "Build micro benchmarks: No  (default)")
+endif()
+
 # if(SQL)
 #   message(STATUS "Install SQL-files     : Yes")
 # else()
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "Common.h"
+
+#include <chrono>
+#include <string>
+
+/// Command line options passed to every benchmark
+struct BenchmarkOptions
+{
+    uint32 size;                                            // problem size, 0 selects the default of the benchmark
+    uint32 rounds;                                          // repetitions of the measured workload
+    uint32 seed;                                            // seed of the generated workloads
+    std::string file;                                       // input file of replay benchmarks
+    std::string dataDir;                                    // server data directory with the extracted vmaps
+};
+
+/// Returns 0 on success, non zero if a result check failed
+typedef int (*BenchmarkFunc)(BenchmarkOptions const& options);
+
+class BenchmarkTimer
+{
+    public:
+        BenchmarkTimer() : m_start(Clock::now()) {}
+
+        void Restart() { m_start = Clock::now(); }
+        double ElapsedMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count(); }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point m_start;
+};
+
+/// Prints one result line: total time and time per operation
+void ReportBenchmark(char const* name, double ms, uint64 operations);
+
+int ThreatBenchmark(BenchmarkOptions const& options);
+int GuidSetBenchmark(BenchmarkOptions const& options);
+int UpdateMaskBenchmark(BenchmarkOptions const& options);
+int EventBenchmark(BenchmarkOptions const& options);
+int LineOfSightBenchmark(BenchmarkOptions const& options);
+
+#endif
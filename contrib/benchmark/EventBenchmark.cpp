@@ -0,0 +1,386 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Event trace replayed on the timing wheel EventProcessor and on a copy of the former
+/// std::multimap one, both must execute the same events at the same times in the same order.
+///
+/// Trace file format, one operation per line, # starts a comment:
+///   processors <count>                            number of processors, first line
+///   U <diff>                                      Update(diff) of all processors
+///   A <processor> <offset> [<repeats> <interval>] AddEvent at CalculateTime(offset), the event
+///                                                 adds itself again repeats times every interval ms
+///   K <processor>                                 KillAllEvents(false)
+/// Without a trace file a world of units with spell hits, periodic and long timers is generated.
+
+#include "Benchmark.h"
+#include "Utilities/EventProcessor.h"
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // EventProcessor before it used a timing wheel
+    class LegacyEventProcessor
+    {
+        public:
+            LegacyEventProcessor() : m_time(0), m_aborting(false) {}
+            ~LegacyEventProcessor() { KillAllEvents(true); }
+
+            void Update(uint32 p_time)
+            {
+                // update time
+                m_time += p_time;
+
+                // main event loop
+                EventList::iterator i;
+                while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+                {
+                    // get and remove event from queue
+                    BasicEvent* Event = i->second;
+                    m_events.erase(i);
+
+                    if (!Event->to_Abort)
+                    {
+                        if (Event->Execute(m_time, p_time))
+                        {
+                            // completely destroy event if it is not re-added
+                            delete Event;
+                        }
+                    }
+                    else
+                    {
+                        Event->Abort(m_time);
+                        delete Event;
+                    }
+                }
+            }
+
+            void KillAllEvents(bool force)
+            {
+                // prevent event insertions
+                m_aborting = true;
+
+                // first, abort all existing events
+                for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+                {
+                    EventList::iterator i_old = i;
+                    ++i;
+
+                    i_old->second->to_Abort = true;
+                    i_old->second->Abort(m_time);
+                    if (force || i_old->second->IsDeletable())
+                    {
+                        delete i_old->second;
+
+                        if (!force)                         // need per-element cleanup
+                            m_events.erase(i_old);
+                    }
+                }
+
+                // fast clear event list (in force case)
+                if (force)
+                    m_events.clear();
+            }
+
+            void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true)
+            {
+                if (set_addtime)
+                    Event->m_addTime = m_time;
+
+                Event->m_execTime = e_time;
+                m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+            }
+
+            uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+
+        private:
+            typedef std::multimap<uint64, BasicEvent*> EventList;
+
+            uint64 m_time;
+            EventList m_events;
+            bool m_aborting;
+    };
+
+    enum TraceOpType
+    {
+        TRACE_OP_UPDATE,
+        TRACE_OP_ADD,
+        TRACE_OP_KILL,
+    };
+
+    struct TraceOp
+    {
+        TraceOpType type;
+        uint32 processor;
+        uint32 time;                                        // update diff or event offset
+        uint32 repeats;
+        uint32 interval;
+    };
+
+    struct EventTrace
+    {
+        uint32 processors;
+        std::vector<TraceOp> ops;
+    };
+
+    // executed events in order and aborted events in any order, hashed so the replay does not allocate
+    struct ExecutionLog
+    {
+        ExecutionLog() : executedHash(14695981039346656037ULL), abortedSum(0), executed(0), aborted(0) {}
+
+        static uint64 Mix(uint64 value)
+        {
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+        void Executed(uint32 id, uint64 time)
+        {
+            executedHash = (executedHash ^ Mix((uint64(id) << 32) ^ time)) * 1099511628211ULL;
+            ++executed;
+        }
+
+        // the wheel aborts events in no particular order
+        void Aborted(uint32 id, uint64 time)
+        {
+            abortedSum += Mix((uint64(id) << 32) ^ time);
+            ++aborted;
+        }
+
+        bool operator==(ExecutionLog const& other) const
+        {
+            return executedHash == other.executedHash && abortedSum == other.abortedSum &&
+                   executed == other.executed && aborted == other.aborted;
+        }
+
+        uint64 executedHash;
+        uint64 abortedSum;
+        uint64 executed;
+        uint64 aborted;
+    };
+
+    template<class Processor>
+    class TraceEvent : public BasicEvent
+    {
+        public:
+            TraceEvent(Processor& processor, ExecutionLog& log, uint32 id, uint32 repeats, uint32 interval) :
+                m_processor(processor), m_log(log), m_id(id), m_repeats(repeats), m_interval(interval) {}
+
+            bool Execute(uint64 e_time, uint32 /*p_time*/) override
+            {
+                m_log.Executed(m_id, e_time);
+
+                if (!m_repeats)
+                    return true;
+
+                --m_repeats;
+                m_processor.AddEvent(this, m_processor.CalculateTime(m_interval));
+                return false;
+            }
+
+            void Abort(uint64 e_time) override
+            {
+                m_log.Aborted(m_id, e_time);
+            }
+
+        private:
+            Processor& m_processor;
+            ExecutionLog& m_log;
+            uint32 m_id;
+            uint32 m_repeats;
+            uint32 m_interval;
+    };
+
+    bool LoadTrace(std::string const& fileName, EventTrace& trace)
+    {
+        std::ifstream file(fileName.c_str());
+        if (!file)
+        {
+            printf("  cannot open trace %s\n", fileName.c_str());
+            return false;
+        }
+
+        trace.processors = 0;
+        std::string line;
+        for (uint32 lineNumber = 1; std::getline(file, line); ++lineNumber)
+        {
+            std::istringstream fields(line.substr(0, line.find('#')));
+            std::string type;
+            if (!(fields >> type))
+                continue;
+
+            TraceOp op = { TRACE_OP_UPDATE, 0, 0, 0, 0 };
+            bool valid;
+            if (type == "processors")
+                valid = !trace.processors && bool(fields >> trace.processors) && trace.processors;
+            else if (type == "U")
+                valid = bool(fields >> op.time);
+            else if (type == "A")
+            {
+                op.type = TRACE_OP_ADD;
+                valid = bool(fields >> op.processor >> op.time);
+                if (valid && !(fields >> op.repeats >> op.interval))
+                    op.repeats = op.interval = 0;
+            }
+            else if (type == "K")
+            {
+                op.type = TRACE_OP_KILL;
+                valid = bool(fields >> op.processor);
+            }
+            else
+                valid = false;
+
+            if (valid && type != "processors")
+            {
+                valid = trace.processors && op.processor < trace.processors;
+                trace.ops.push_back(op);
+            }
+
+            if (!valid)
+            {
+                printf("  invalid trace line %u: %s\n", lineNumber, line.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // units in a busy world: spell hits and casts, periodic auras and long timers like respawns
+    EventTrace GenerateTrace(uint32 processors, uint32 updates, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> processorDist(0, processors - 1);
+        std::uniform_int_distribution<uint32> diffDist(40, 60);
+        std::uniform_int_distribution<uint32> kindDist(0, 999);
+        std::uniform_int_distribution<uint32> hitDist(0, 3000);
+        std::uniform_int_distribution<uint32> periodDist(1, 6);
+        std::uniform_int_distribution<uint32> repeatDist(2, 20);
+        std::uniform_int_distribution<uint32> timerDist(60000, 1800000);
+
+        EventTrace trace;
+        trace.processors = processors;
+        for (uint32 update = 0; update < updates; ++update)
+        {
+            // a tenth of the units adds an event per world update
+            for (uint32 i = processors / 10; i > 0; --i)
+            {
+                TraceOp op = { TRACE_OP_ADD, processorDist(rng), 0, 0, 0 };
+                uint32 kind = kindDist(rng);
+                if (kind < 700)
+                    op.time = hitDist(rng);
+                else if (kind < 950)
+                {
+                    op.interval = periodDist(rng) * 500;
+                    op.time = op.interval;
+                    op.repeats = repeatDist(rng);
+                }
+                else if (kind < 998)
+                    op.time = timerDist(rng);
+                else
+                    op.type = TRACE_OP_KILL;
+                trace.ops.push_back(op);
+            }
+
+            TraceOp op = { TRACE_OP_UPDATE, 0, diffDist(rng), 0, 0 };
+            trace.ops.push_back(op);
+        }
+
+        return trace;
+    }
+
+    template<class Processor>
+    ExecutionLog ReplayTrace(EventTrace const& trace)
+    {
+        ExecutionLog log;
+
+        {
+            // events left at the end are aborted by the processor destructors
+            std::vector<Processor> processors(trace.processors);
+            uint32 id = 0;
+
+            for (TraceOp const& op : trace.ops)
+            {
+                switch (op.type)
+                {
+                    case TRACE_OP_UPDATE:
+                        for (Processor& processor : processors)
+                            processor.Update(op.time);
+                        break;
+                    case TRACE_OP_ADD:
+                    {
+                        Processor& processor = processors[op.processor];
+                        processor.AddEvent(new TraceEvent<Processor>(processor, log, ++id, op.repeats, op.interval), processor.CalculateTime(op.time));
+                        break;
+                    }
+                    case TRACE_OP_KILL:
+                        processors[op.processor].KillAllEvents(false);
+                        break;
+                }
+            }
+        }
+
+        return log;
+    }
+}
+
+int EventBenchmark(BenchmarkOptions const& options)
+{
+    EventTrace trace;
+    if (!options.file.empty())
+    {
+        if (!LoadTrace(options.file, trace))
+            return 1;
+    }
+    else
+        trace = GenerateTrace(options.size ? options.size : 2000, 2000, options.seed);
+
+    ExecutionLog wheelLog, legacyLog;
+    double wheelMs = 0.0, legacyMs = 0.0;
+
+    for (uint32 round = 0; round < options.rounds; ++round)
+    {
+        BenchmarkTimer timer;
+        wheelLog = ReplayTrace<EventProcessor>(trace);
+        wheelMs += timer.ElapsedMs();
+
+        timer.Restart();
+        legacyLog = ReplayTrace<LegacyEventProcessor>(trace);
+        legacyMs += timer.ElapsedMs();
+    }
+
+    uint64 const operations = (uint64(trace.ops.size()) + wheelLog.executed) * options.rounds;
+    printf("  %u processors, %u trace operations, %llu events executed, %u rounds\n", trace.processors, uint32(trace.ops.size()),
+           (unsigned long long)wheelLog.executed, options.rounds);
+    ReportBenchmark("timing wheel EventProcessor", wheelMs, operations);
+    ReportBenchmark("std::multimap EventProcessor", legacyMs, operations);
+
+    if (!(wheelLog == legacyLog))
+    {
+        printf("  executed events differ from the std::multimap EventProcessor\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Objects known by a client, GuidFlatSet against std::set
+///
+/// Random inserts and erases are first checked against std::set, with a small guid
+/// range so the set runs at its maximal load and erase has to shift long probe
+/// sequences back. Then the visibility updates of a player are replayed on both
+/// containers: copy the known guids, check every object in range and add or remove
+/// the ones entering or leaving the visibility distance.
+
+#include "Benchmark.h"
+#include "Entities/ObjectGuid.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+    typedef std::set<ObjectGuid> GuidTreeSet;
+
+    bool Insert(GuidFlatSet& guids, ObjectGuid guid) { return guids.insert(guid); }
+    bool Insert(GuidTreeSet& guids, ObjectGuid guid) { return guids.insert(guid).second; }
+    bool Contains(GuidFlatSet const& guids, ObjectGuid guid) { return guids.contains(guid); }
+    bool Contains(GuidTreeSet const& guids, ObjectGuid guid) { return guids.find(guid) != guids.end(); }
+
+    // players and creatures mixed, as in a city
+    ObjectGuid MakeGuid(uint32 index)
+    {
+        return index % 3 ? ObjectGuid(HIGHGUID_UNIT, 3000 + index % 50, index + 1) : ObjectGuid(HIGHGUID_PLAYER, index + 1);
+    }
+
+    bool SameContent(GuidFlatSet const& flat, GuidTreeSet const& tree)
+    {
+        if (flat.size() != tree.size())
+            return false;
+
+        std::vector<ObjectGuid> guids(flat.begin(), flat.end());
+        std::sort(guids.begin(), guids.end());
+        return std::equal(guids.begin(), guids.end(), tree.begin());
+    }
+
+    // returns the number of the first operation with a different result, 0 if none
+    uint32 CompareWithTreeSet(uint32 range, uint32 operations, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> guidDist(0, range - 1);
+        std::uniform_int_distribution<uint32> opDist(0, 99);
+
+        GuidFlatSet flat;
+        GuidTreeSet tree;
+        for (uint32 op = 1; op <= operations; ++op)
+        {
+            ObjectGuid guid = MakeGuid(guidDist(rng));
+            uint32 roll = opDist(rng);
+            bool same;
+            if (roll < 45)
+                same = Insert(flat, guid) == Insert(tree, guid);
+            else if (roll < 90)
+                same = flat.erase(guid) == tree.erase(guid);
+            else if (roll < 99)
+                same = (flat.find(guid) != flat.end()) == Contains(tree, guid);
+            else
+            {
+                // refill from a copy, as after a client reset
+                GuidFlatSet copy = flat;
+                flat.clear();
+                tree.clear();
+                same = true;
+                for (GuidFlatSet::const_iterator itr = copy.begin(); itr != copy.end(); ++itr)
+                    if (opDist(rng) < 50)
+                        same = Insert(flat, *itr) == Insert(tree, *itr) && same;
+            }
+
+            if (!same || ((op % 997) == 0 && !SameContent(flat, tree)))
+                return op;
+        }
+
+        return SameContent(flat, tree) ? 0 : operations;
+    }
+
+    struct VisibilityUpdate
+    {
+        std::vector<uint32> inRange;                        // objects checked by the visibility update
+        std::vector<uint32> visible;                        // subset of inRange seen by the player
+    };
+
+    // a player walking through a crowded city, objects enter and leave the visibility distance
+    std::vector<VisibilityUpdate> GenerateWalk(uint32 objects, uint32 updates, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> percentDist(0, 99);
+
+        std::vector<VisibilityUpdate> walk(updates);
+        uint32 const total = objects + objects / 2;
+        uint32 first = 0;
+        for (VisibilityUpdate& update : walk)
+        {
+            // the range window moves over all objects, a few at its border flicker
+            first = (first + objects / 50 + 1) % total;
+            for (uint32 i = 0; i < objects; ++i)
+            {
+                uint32 index = (first + i) % total;
+                update.inRange.push_back(index);
+                if (i < objects - objects / 10 || percentDist(rng) < 50)
+                    update.visible.push_back(index);
+            }
+        }
+
+        return walk;
+    }
+
+    template<class GuidSet>
+    uint64 ReplayWalk(std::vector<VisibilityUpdate> const& walk, std::vector<ObjectGuid> const& guids)
+    {
+        GuidSet clientGuids;
+        uint64 changes = 0;
+
+        for (VisibilityUpdate const& update : walk)
+        {
+            // VisibleNotifier works on a copy of the known guids, left over ones go out of range
+            GuidSet notifierGuids = clientGuids;
+
+            std::vector<uint32>::const_iterator visible = update.visible.begin();
+            for (uint32 index : update.inRange)
+            {
+                ObjectGuid const& guid = guids[index];
+                bool isVisible = visible != update.visible.end() && *visible == index;
+                if (isVisible)
+                    ++visible;
+
+                if (Contains(clientGuids, guid))
+                {
+                    notifierGuids.erase(guid);
+                    if (!isVisible)
+                    {
+                        clientGuids.erase(guid);
+                        ++changes;
+                    }
+                }
+                else if (isVisible)
+                {
+                    Insert(clientGuids, guid);
+                    ++changes;
+                }
+            }
+
+            for (typename GuidSet::const_iterator itr = notifierGuids.begin(); itr != notifierGuids.end(); ++itr)
+            {
+                clientGuids.erase(*itr);
+                ++changes;
+            }
+        }
+
+        return changes + clientGuids.size();
+    }
+}
+
+int GuidSetBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const objects = options.size ? options.size : 600;
+    uint32 const updates = 1000;
+
+    // about 190 guids stay in the set, close to the 3/4 load of its 256 slots
+    uint32 failedOp = CompareWithTreeSet(380, 1000000, options.seed);
+    if (!failedOp)
+        failedOp = CompareWithTreeSet(objects * 2, 1000000, options.seed + 1);
+
+    std::vector<ObjectGuid> guids;
+    for (uint32 i = 0; i < objects + objects / 2; ++i)
+        guids.push_back(MakeGuid(i));
+
+    std::vector<VisibilityUpdate> walk = GenerateWalk(objects, updates, options.seed);
+    uint64 flatResult = 0, treeResult = 0;
+    double flatMs = 0.0, treeMs = 0.0;
+
+    for (uint32 round = 0; round < options.rounds; ++round)
+    {
+        BenchmarkTimer timer;
+        flatResult = ReplayWalk<GuidFlatSet>(walk, guids);
+        flatMs += timer.ElapsedMs();
+
+        timer.Restart();
+        treeResult = ReplayWalk<GuidTreeSet>(walk, guids);
+        treeMs += timer.ElapsedMs();
+    }
+
+    uint64 const operations = uint64(objects) * updates * options.rounds;
+    printf("  %u objects in range, %u visibility updates, %u rounds\n", objects, updates, options.rounds);
+    ReportBenchmark("GuidFlatSet", flatMs, operations);
+    ReportBenchmark("std::set", treeMs, operations);
+
+    if (failedOp)
+    {
+        printf("  GuidFlatSet differs from std::set at random operation %u\n", failedOp);
+        return 1;
+    }
+
+    if (flatResult != treeResult)
+    {
+        printf("  visibility changes differ from std::set\n");
+        return 1;
+    }
+
+    return 0;
+}
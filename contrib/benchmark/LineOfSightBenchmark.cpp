@@ -0,0 +1,233 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Line of sight checks of units fighting in a city
+///
+/// Units stand in the Stormwind trade district, on the heights of the extracted
+/// vmaps. Every map tick some of them move, cast spells and select random targets.
+/// The lines are checked on the static tree directly and through the per tick
+/// LineOfSightCache of the map, both must give the same results.
+
+#include "Benchmark.h"
+#include "Maps/GridDefines.h"
+#include "Maps/LineOfSightCache.h"
+#include "vmap/VMapManager2.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    uint32 const CITY_MAP_ID = 0;
+    float const CITY_X = -8833.0f;
+    float const CITY_Y = 628.0f;
+    float const CITY_Z = 94.0f;
+    float const CITY_RADIUS = 60.0f;
+    float const SPELL_RANGE = 30.0f;
+
+    struct Line
+    {
+        float x1, y1, z1, x2, y2, z2;
+    };
+
+    struct LineOfSightTick
+    {
+        std::vector<Line> lines;
+    };
+
+    struct CityUnit
+    {
+        float x, y, z;
+    };
+
+    void PlaceUnit(VMAP::IVMapManager& vmgr, CityUnit& unit, float x, float y)
+    {
+        unit.x = x;
+        unit.y = y;
+        unit.z = vmgr.getHeight(CITY_MAP_ID, x, y, CITY_Z + 20.0f, 50.0f);
+        if (unit.z < VMAP_INVALID_HEIGHT)
+            unit.z = CITY_Z;
+    }
+
+    // as WorldObject::IsWithinLOSInMap, from eye height to eye height
+    void AddLine(LineOfSightTick& tick, CityUnit const& source, CityUnit const& target)
+    {
+        Line line = { source.x, source.y, source.z + 2.0f, target.x, target.y, target.z + 2.0f };
+        tick.lines.push_back(line);
+    }
+
+    bool InSpellRange(CityUnit const& source, CityUnit const& target)
+    {
+        float dx = source.x - target.x;
+        float dy = source.y - target.y;
+        return dx * dx + dy * dy < SPELL_RANGE * SPELL_RANGE;
+    }
+
+    std::vector<LineOfSightTick> GenerateFight(VMAP::IVMapManager& vmgr, uint32 unitCount, uint32 ticks, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> posDist(-CITY_RADIUS, CITY_RADIUS);
+        std::uniform_real_distribution<float> stepDist(-3.0f, 3.0f);
+        std::uniform_int_distribution<uint32> unitDist(0, unitCount - 1);
+        std::uniform_int_distribution<uint32> percentDist(0, 99);
+
+        std::vector<CityUnit> units(unitCount);
+        for (CityUnit& unit : units)
+            PlaceUnit(vmgr, unit, CITY_X + posDist(rng), CITY_Y + posDist(rng));
+
+        std::vector<LineOfSightTick> fight(ticks);
+        for (LineOfSightTick& tick : fight)
+        {
+            for (CityUnit& unit : units)
+                if (percentDist(rng) < 25)
+                    PlaceUnit(vmgr, unit, unit.x + stepDist(rng), unit.y + stepDist(rng));
+
+            for (CityUnit const& unit : units)
+            {
+                uint32 roll = percentDist(rng);
+                if (roll < 25)
+                {
+                    // spell cast: checked on prepare and again when it hits
+                    CityUnit const& target = units[unitDist(rng)];
+                    if (&target != &unit && InSpellRange(unit, target))
+                    {
+                        AddLine(tick, unit, target);
+                        AddLine(tick, unit, target);
+                    }
+                }
+                else if (roll < 35)
+                {
+                    // random target selection checks every unit in range
+                    for (CityUnit const& target : units)
+                        if (&target != &unit && InSpellRange(unit, target))
+                            AddLine(tick, unit, target);
+                }
+            }
+        }
+
+        return fight;
+    }
+
+    uint64 ReplayFight(VMAP::IVMapManager& vmgr, std::vector<LineOfSightTick> const& fight, std::vector<bool>& results)
+    {
+        uint64 visible = 0;
+        results.clear();
+
+        for (LineOfSightTick const& tick : fight)
+        {
+            for (Line const& line : tick.lines)
+            {
+                bool result = vmgr.isInLineOfSight(CITY_MAP_ID, line.x1, line.y1, line.z1, line.x2, line.y2, line.z2);
+                results.push_back(result);
+                visible += result;
+            }
+        }
+
+        return visible;
+    }
+
+    // as Map::IsInLineOfSight without dynamic gameobject models, the cache is cleared by Map::Update
+    uint64 ReplayCachedFight(VMAP::IVMapManager& vmgr, std::vector<LineOfSightTick> const& fight, std::vector<bool>& results)
+    {
+        LineOfSightCache cache;
+        uint64 visible = 0;
+        results.clear();
+
+        for (LineOfSightTick const& tick : fight)
+        {
+            cache.Clear();
+            for (Line const& line : tick.lines)
+            {
+                bool result;
+                if (!cache.Find(line.x1, line.y1, line.z1, line.x2, line.y2, line.z2, result))
+                {
+                    result = vmgr.isInLineOfSight(CITY_MAP_ID, line.x1, line.y1, line.z1, line.x2, line.y2, line.z2);
+                    cache.Insert(line.x1, line.y1, line.z1, line.x2, line.y2, line.z2, result);
+                }
+                results.push_back(result);
+                visible += result;
+            }
+        }
+
+        return visible;
+    }
+}
+
+int LineOfSightBenchmark(BenchmarkOptions const& options)
+{
+    if (options.dataDir.empty())
+    {
+        printf("  needs the extracted vmaps, skipped without --data-dir\n");
+        return 0;
+    }
+
+    uint32 const unitCount = options.size ? options.size : 200;
+    uint32 const ticks = 200;
+
+    std::string vmapsDir = options.dataDir + "/vmaps";
+    VMAP::VMapManager2 vmgr;
+
+    // the city tile and its neighbours, as loaded by TerrainInfo::GetGrid
+    int gx = int(CENTER_GRID_ID - CITY_X / SIZE_OF_GRIDS);
+    int gy = int(CENTER_GRID_ID - CITY_Y / SIZE_OF_GRIDS);
+    for (int x = gx - 1; x <= gx + 1; ++x)
+    {
+        for (int y = gy - 1; y <= gy + 1; ++y)
+        {
+            if (vmgr.loadMap(vmapsDir.c_str(), CITY_MAP_ID, x, y) == VMAP::VMAP_LOAD_RESULT_ERROR && x == gx && y == gy)
+            {
+                printf("  cannot load vmap tile %d,%d of map %u from %s\n", x, y, CITY_MAP_ID, vmapsDir.c_str());
+                return 1;
+            }
+        }
+    }
+
+    std::vector<LineOfSightTick> fight = GenerateFight(vmgr, unitCount, ticks, options.seed);
+    uint64 lines = 0;
+    for (LineOfSightTick const& tick : fight)
+        lines += tick.lines.size();
+
+    std::vector<bool> treeResults, cacheResults;
+    uint64 treeVisible = 0, cacheVisible = 0;
+    double treeMs = 0.0, cacheMs = 0.0;
+
+    for (uint32 round = 0; round < options.rounds; ++round)
+    {
+        BenchmarkTimer timer;
+        treeVisible = ReplayFight(vmgr, fight, treeResults);
+        treeMs += timer.ElapsedMs();
+
+        timer.Restart();
+        cacheVisible = ReplayCachedFight(vmgr, fight, cacheResults);
+        cacheMs += timer.ElapsedMs();
+    }
+
+    uint64 const operations = lines * options.rounds;
+    printf("  %u units, %u map ticks, %llu lines, %llu visible, %u rounds\n", unitCount, ticks,
+           (unsigned long long)lines, (unsigned long long)treeVisible, options.rounds);
+    ReportBenchmark("static tree per line", treeMs, operations);
+    ReportBenchmark("LineOfSightCache cleared per tick", cacheMs, operations);
+
+    if (treeVisible != cacheVisible || treeResults != cacheResults)
+    {
+        printf("  cached line of sight differs from the static tree\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Micro benchmarks of game server data structures
+
+#include "Common.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "Benchmark.h"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+// referenced by the game library, never connected
+DatabaseType WorldDatabase;
+DatabaseType CharacterDatabase;
+DatabaseType LoginDatabase;
+
+struct BenchmarkEntry
+{
+    char const* name;
+    char const* description;
+    BenchmarkFunc func;
+};
+
+static BenchmarkEntry const benchmarks[] =
+{
+    { "threat",     "threat list of one creature with hundreds of attackers (size: attackers)",         &ThreatBenchmark      },
+    { "guidset",    "guids known by a client in a crowded city (size: objects in range)",               &GuidSetBenchmark     },
+    { "updatemask", "values updates of changed unit and player fields (size: viewers)",                 &UpdateMaskBenchmark  },
+    { "events",     "event trace of --file or of generated units on EventProcessor (size: units)",      &EventBenchmark       },
+    { "los",        "line of sight of units fighting in a city, needs --data-dir (size: units)",        &LineOfSightBenchmark },
+};
+
+void ReportBenchmark(char const* name, double ms, uint64 operations)
+{
+    printf("  %-44s %10.2f ms %10.1f ns/op\n", name, ms, operations ? ms * 1000000.0 / operations : 0.0);
+}
+
+static void ListBenchmarks()
+{
+    for (BenchmarkEntry const& entry : benchmarks)
+        printf("  %-12s %s\n", entry.name, entry.description);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    std::vector<std::string> names;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+        ("help,h", "print usage and exit")
+        ("list,l", "list the benchmarks")
+        ("size,n", boost::program_options::value<uint32>(&options.size)->default_value(0), "problem size, 0 for the default of each benchmark")
+        ("rounds,r", boost::program_options::value<uint32>(&options.rounds)->default_value(5), "repetitions of each workload")
+        ("seed", boost::program_options::value<uint32>(&options.seed)->default_value(1), "seed of the generated workloads")
+        ("file,f", boost::program_options::value<std::string>(&options.file), "input file of replay benchmarks")
+        ("data-dir", boost::program_options::value<std::string>(&options.dataDir), "server data directory with the extracted vmaps")
+        ("benchmark", boost::program_options::value<std::vector<std::string> >(&names), "benchmarks to run, all if none given");
+
+    boost::program_options::positional_options_description positional;
+    positional.add("benchmark", -1);
+
+    boost::program_options::variables_map vm;
+
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << "Usage: benchmark [options] [benchmark...]" << std::endl << desc << std::endl << "Benchmarks:" << std::endl;
+        ListBenchmarks();
+        return 0;
+    }
+
+    if (vm.count("list"))
+    {
+        ListBenchmarks();
+        return 0;
+    }
+
+    if (!options.rounds)
+        options.rounds = 1;
+
+    int failed = 0;
+    bool found = names.empty();
+    for (BenchmarkEntry const& entry : benchmarks)
+    {
+        if (!names.empty() && std::find(names.begin(), names.end(), entry.name) == names.end())
+            continue;
+
+        found = true;
+        printf("%s:\n", entry.name);
+        if (entry.func(options))
+        {
+            sLog.outError("Benchmark %s: result check failed", entry.name);
+            ++failed;
+        }
+    }
+
+    if (!found)
+    {
+        sLog.outError("Unknown benchmark, use --list to show them");
+        return 1;
+    }
+
+    return failed ? 1 : 0;
+}
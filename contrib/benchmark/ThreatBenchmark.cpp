@@ -0,0 +1,240 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Threat list of one creature attacked by hundreds of units
+///
+/// The same generated fight is replayed on the ThreatManager and on a model of the
+/// former container, which kept an unordered list, looked references up linearly
+/// and sorted the whole list before selecting a victim after threat changed.
+
+#include "Benchmark.h"
+#include "Entities/Creature.h"
+#include "Combat/ThreatManager.h"
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // never added to a map, only its guid, threat manager and hostile references are used
+    class BenchmarkCreature : public Creature
+    {
+        public:
+            explicit BenchmarkCreature(uint32 guidLow) { Object::_Create(guidLow, 1, HIGHGUID_UNIT); }
+    };
+
+    enum ThreatOpType
+    {
+        THREAT_OP_ADD,                                      // damage or heal threat
+        THREAT_OP_PERCENT,                                  // fade like threat reduction
+        THREAT_OP_REMOVE,                                   // target left the fight, threat percent below -100
+        THREAT_OP_SELECT,                                   // victim selection of the creature update
+    };
+
+    struct ThreatOp
+    {
+        ThreatOpType type;
+        uint32 attacker;
+        float value;
+    };
+
+    // the unordered list with sort on demand as used before the container was kept ordered
+    class ThreatListModel
+    {
+        public:
+            ThreatListModel() : m_dirty(false) {}
+
+            void AddThreat(ObjectGuid guid, float threat)
+            {
+                for (Ref& ref : m_refs)
+                {
+                    if (ref.guid == guid)
+                    {
+                        ref.threat = std::max(0.0f, ref.threat + threat);
+                        m_dirty = true;
+                        return;
+                    }
+                }
+
+                m_refs.push_back(Ref(guid, std::max(0.0f, threat)));
+                m_dirty = true;
+            }
+
+            void ModifyThreatPercent(ObjectGuid guid, int32 percent)
+            {
+                for (std::list<Ref>::iterator itr = m_refs.begin(); itr != m_refs.end(); ++itr)
+                {
+                    if (itr->guid != guid)
+                        continue;
+
+                    if (percent < -100)
+                        m_refs.erase(itr);
+                    else
+                        itr->threat += itr->threat * percent / 100.0f;
+                    m_dirty = true;
+                    return;
+                }
+            }
+
+            float SelectVictim()
+            {
+                if (m_dirty && m_refs.size() > 1)
+                    m_refs.sort([](Ref const& lhs, Ref const& rhs) { return lhs.threat > rhs.threat; });
+                m_dirty = false;
+                return m_refs.empty() ? 0.0f : m_refs.front().threat;
+            }
+
+        private:
+            struct Ref
+            {
+                Ref(ObjectGuid g, float t) : guid(g), threat(t) {}
+                ObjectGuid guid;
+                float threat;
+            };
+
+            std::list<Ref> m_refs;
+            bool m_dirty;
+    };
+
+    // every attacker hits once per creature update, a few fade or leave the fight
+    std::vector<ThreatOp> GenerateFight(uint32 attackers, uint32 updates, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> attackerDist(0, attackers - 1);
+        std::uniform_real_distribution<float> threatDist(10.0f, 1500.0f);
+        std::uniform_int_distribution<uint32> percentDist(0, 999);
+
+        std::vector<ThreatOp> ops;
+        ops.reserve(size_t(updates) * (attackers + 1));
+        for (uint32 update = 0; update < updates; ++update)
+        {
+            for (uint32 i = 0; i < attackers; ++i)
+            {
+                ThreatOp op = { THREAT_OP_ADD, attackerDist(rng), threatDist(rng) };
+                uint32 roll = percentDist(rng);
+                if (roll < 5)
+                    op.type = THREAT_OP_REMOVE;
+                else if (roll < 20)
+                {
+                    op.type = THREAT_OP_PERCENT;
+                    op.value = -50.0f;
+                }
+                ops.push_back(op);
+            }
+
+            ThreatOp select = { THREAT_OP_SELECT, 0, 0.0f };
+            ops.push_back(select);
+        }
+
+        return ops;
+    }
+
+    bool IsOrdered(ThreatList const& threatList)
+    {
+        float last = -1.0f;
+        for (ThreatList::const_iterator itr = threatList.begin(); itr != threatList.end(); ++itr)
+        {
+            if (last >= 0.0f && (*itr)->getThreat() > last)
+                return false;
+            last = (*itr)->getThreat();
+        }
+        return true;
+    }
+}
+
+int ThreatBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const attackers = options.size ? options.size : 400;
+    uint32 const updates = 200;
+
+    BenchmarkCreature* creature = new BenchmarkCreature(1);
+    std::vector<BenchmarkCreature*> units;
+    for (uint32 i = 0; i < attackers; ++i)
+        units.push_back(new BenchmarkCreature(i + 2));
+
+    std::vector<ThreatOp> ops = GenerateFight(attackers, updates, options.seed);
+    std::vector<float> managerVictims, modelVictims;
+    double managerMs = 0.0, modelMs = 0.0;
+    bool ordered = true;
+
+    for (uint32 round = 0; round < options.rounds; ++round)
+    {
+        ThreatManager& threatManager = creature->getThreatManager();
+        managerVictims.clear();
+
+        BenchmarkTimer timer;
+        for (ThreatOp const& op : ops)
+        {
+            switch (op.type)
+            {
+                case THREAT_OP_ADD:     threatManager.addThreatDirectly(units[op.attacker], op.value); break;
+                case THREAT_OP_PERCENT: threatManager.modifyThreatPercent(units[op.attacker], int32(op.value)); break;
+                case THREAT_OP_REMOVE:  threatManager.modifyThreatPercent(units[op.attacker], -101); break;
+                case THREAT_OP_SELECT:
+                {
+                    ThreatList const& threatList = threatManager.getThreatList();
+                    managerVictims.push_back(threatList.empty() ? 0.0f : threatList.front()->getThreat());
+                    break;
+                }
+            }
+        }
+        managerMs += timer.ElapsedMs();
+
+        ordered = ordered && IsOrdered(threatManager.getThreatList());
+        threatManager.clearReferences();
+
+        ThreatListModel model;
+        modelVictims.clear();
+
+        timer.Restart();
+        for (ThreatOp const& op : ops)
+        {
+            ObjectGuid guid = units[op.attacker]->GetObjectGuid();
+            switch (op.type)
+            {
+                case THREAT_OP_ADD:     model.AddThreat(guid, op.value); break;
+                case THREAT_OP_PERCENT: model.ModifyThreatPercent(guid, int32(op.value)); break;
+                case THREAT_OP_REMOVE:  model.ModifyThreatPercent(guid, -101); break;
+                case THREAT_OP_SELECT:  modelVictims.push_back(model.SelectVictim()); break;
+            }
+        }
+        modelMs += timer.ElapsedMs();
+    }
+
+    // units are not in a map, deleting them would run the map cleanups
+    uint64 const operations = uint64(ops.size()) * options.rounds;
+    printf("  %u attackers, %u creature updates, %u rounds\n", attackers, updates, options.rounds);
+    ReportBenchmark("ordered ThreatContainer", managerMs, operations);
+    ReportBenchmark("list sorted on victim selection", modelMs, operations);
+
+    if (!ordered)
+    {
+        printf("  threat list is not ordered by threat\n");
+        return 1;
+    }
+
+    if (managerVictims != modelVictims)
+    {
+        printf("  most hated threat differs from the list model\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Values updates of units and players seen by many clients
+///
+/// Replays the same field changes on the fixed size UpdateMask and on a copy of the
+/// former heap allocated mask with the changed fields in a std::vector<bool>, which
+/// built every mask by testing each field and wrote the values by testing each bit.
+
+#include "Benchmark.h"
+#include "ByteBuffer.h"
+#include "Entities/UpdateMask.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    // UpdateMask before it was made fixed size
+    class LegacyUpdateMask
+    {
+        public:
+            LegacyUpdateMask() : mCount(0), mBlocks(0), mUpdateMask(nullptr) { }
+            ~LegacyUpdateMask() { delete[] mUpdateMask; }
+
+            void SetBit(uint32 index) { ((uint8*)mUpdateMask)[ index >> 3 ] |= 1 << (index & 0x7); }
+            bool GetBit(uint32 index) const { return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0; }
+
+            uint32 GetBlockCount() const { return mBlocks; }
+            uint32 GetLength() const { return mBlocks << 2; }
+            uint8* GetMask() { return (uint8*)mUpdateMask; }
+
+            void SetCount(uint32 valuesCount)
+            {
+                delete[] mUpdateMask;
+
+                mCount = valuesCount;
+                mBlocks = (valuesCount + 31) / 32;
+
+                mUpdateMask = new uint32[mBlocks];
+                memset(mUpdateMask, 0, mBlocks << 2);
+            }
+
+        private:
+            uint32 mCount;
+            uint32 mBlocks;
+            uint32* mUpdateMask;
+    };
+
+    struct ValuesChange
+    {
+        bool player;
+        std::vector<uint16> fields;
+    };
+
+    // a few fields like health, power or auras change per object update
+    std::vector<ValuesChange> GenerateChanges(uint32 updates, uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> typeDist(0, 3);
+        std::uniform_int_distribution<uint32> countDist(1, 8);
+        std::uniform_int_distribution<uint16> unitFieldDist(OBJECT_END, UNIT_END - 1);
+        std::uniform_int_distribution<uint16> playerFieldDist(UNIT_END, PLAYER_END - 1);
+
+        std::vector<ValuesChange> changes(updates);
+        for (ValuesChange& change : changes)
+        {
+            change.player = typeDist(rng) == 0;
+            for (uint32 i = countDist(rng); i > 0; --i)
+                change.fields.push_back(change.player && typeDist(rng) == 0 ? playerFieldDist(rng) : unitFieldDist(rng));
+        }
+
+        return changes;
+    }
+
+    void BuildUpdate(ByteBuffer& data, UpdateMask& updateMask, uint32 const* values, uint32 valuesCount)
+    {
+        data << uint8(updateMask.GetBlockCount());
+        data.append(updateMask.GetMask(), updateMask.GetLength());
+
+        for (uint16 index = updateMask.FindNextSetBit(0); index < valuesCount; index = updateMask.FindNextSetBit(index + 1))
+            data << values[index];
+    }
+
+    void BuildUpdate(ByteBuffer& data, LegacyUpdateMask& updateMask, uint32 const* values, uint32 valuesCount)
+    {
+        data << uint8(updateMask.GetBlockCount());
+        data.append(updateMask.GetMask(), updateMask.GetLength());
+
+        for (uint16 index = 0; index < valuesCount; ++index)
+            if (updateMask.GetBit(index))
+                data << values[index];
+    }
+
+    // changes and viewers as in Object::SetUInt32Value, BuildValuesUpdateBlockForPlayer and ClearUpdateMask
+    size_t ReplayChanges(std::vector<ValuesChange> const& changes, uint32 viewers, std::vector<uint32> const& values, ByteBuffer* packets)
+    {
+        ByteBuffer data(500);
+        size_t result = 0;
+
+        UpdateMask changedValues;
+        for (ValuesChange const& change : changes)
+        {
+            uint32 valuesCount = change.player ? PLAYER_END : UNIT_END;
+            if (changedValues.GetCount() != valuesCount)
+                changedValues.SetCount(valuesCount);
+            for (uint16 field : change.fields)
+                changedValues.SetBit(field);
+
+            for (uint32 viewer = 0; viewer < viewers; ++viewer)
+            {
+                UpdateMask updateMask;
+                updateMask.SetCount(valuesCount);
+                updateMask |= changedValues;
+
+                data.clear();
+                BuildUpdate(data, updateMask, values.data(), valuesCount);
+                result += data.size();
+            }
+
+            if (packets)
+                packets->append(data.contents(), data.size());
+
+            changedValues.Clear();
+        }
+
+        return result;
+    }
+
+    size_t ReplayLegacyChanges(std::vector<ValuesChange> const& changes, uint32 viewers, std::vector<uint32> const& values, ByteBuffer* packets)
+    {
+        ByteBuffer data(500);
+        size_t result = 0;
+
+        std::vector<bool> changedValues;
+        for (ValuesChange const& change : changes)
+        {
+            uint32 valuesCount = change.player ? PLAYER_END : UNIT_END;
+            changedValues.resize(valuesCount, false);
+            for (uint16 field : change.fields)
+                changedValues[field] = true;
+
+            for (uint32 viewer = 0; viewer < viewers; ++viewer)
+            {
+                LegacyUpdateMask updateMask;
+                updateMask.SetCount(valuesCount);
+                for (uint16 index = 0; index < valuesCount; ++index)
+                    if (changedValues[index])
+                        updateMask.SetBit(index);
+
+                data.clear();
+                BuildUpdate(data, updateMask, values.data(), valuesCount);
+                result += data.size();
+            }
+
+            if (packets)
+                packets->append(data.contents(), data.size());
+
+            for (uint16 index = 0; index < valuesCount; ++index)
+                changedValues[index] = false;
+        }
+
+        return result;
+    }
+}
+
+int UpdateMaskBenchmark(BenchmarkOptions const& options)
+{
+    uint32 const viewers = options.size ? options.size : 50;
+    uint32 const updates = 20000;
+
+    std::mt19937 rng(options.seed);
+    std::vector<uint32> values(PLAYER_END);
+    for (uint32& value : values)
+        value = rng();
+
+    std::vector<ValuesChange> changes = GenerateChanges(updates, options.seed);
+
+    // the last update of each change must be the same byte for byte
+    ByteBuffer maskPackets, legacyPackets;
+    size_t maskResult = ReplayChanges(changes, 1, values, &maskPackets);
+    size_t legacyResult = ReplayLegacyChanges(changes, 1, values, &legacyPackets);
+    bool samePackets = maskPackets.size() == legacyPackets.size() &&
+                       !memcmp(maskPackets.contents(), legacyPackets.contents(), maskPackets.size());
+
+    double maskMs = 0.0, legacyMs = 0.0;
+
+    for (uint32 round = 0; round < options.rounds; ++round)
+    {
+        BenchmarkTimer timer;
+        maskResult = ReplayChanges(changes, viewers, values, nullptr);
+        maskMs += timer.ElapsedMs();
+
+        timer.Restart();
+        legacyResult = ReplayLegacyChanges(changes, viewers, values, nullptr);
+        legacyMs += timer.ElapsedMs();
+    }
+
+    uint64 const operations = uint64(updates) * viewers * options.rounds;
+    printf("  %u object updates seen by %u viewers, %u rounds\n", updates, viewers, options.rounds);
+    ReportBenchmark("UpdateMask, set bits only", maskMs, operations);
+    ReportBenchmark("heap UpdateMask, every field", legacyMs, operations);
+
+    if (!samePackets || maskResult != legacyResult)
+    {
+        printf("  values updates differ from the former UpdateMask\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,871 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Bot.h"
+#include "Auth/Sha1.h"
+#include "AuthCodes.h"
+#include "Globals/SharedDefines.h"
+#include "Entities/Unit.h"
+#include "Log.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 1.12.1 client
+#define CLIENT_BUILD            5875
+
+// pings more often than every 27 seconds are counted as overspeed pings by mangosd
+#define PING_INTERVAL           30000
+#define BOT_UPDATE_INTERVAL     100
+
+// bots walk back and forth around the login position
+#define BOT_RUN_SPEED           7.0f
+#define BOT_MOVE_RANGE          10.0f
+
+static char const* botChatMessage = "load test message";
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+AuthClientSocket::AuthClientSocket(boost::asio::io_service& service, Bot& bot)
+    : Socket(service, [&bot](Socket*) { bot.OnAuthSocketClosed(); }), m_bot(bot)
+{
+}
+
+void AuthClientSocket::SendLogonChallenge()
+{
+    std::string const& login = m_bot.GetAccountName();
+
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(0x03);
+    pkt << uint16(30 + login.size());                       // size of the remaining packet
+    pkt.append((uint8 const*)"WoW", 4);                     // game name
+    pkt << uint8(1) << uint8(12) << uint8(1);               // version 1.12.1
+    pkt << uint16(CLIENT_BUILD);
+    pkt.append((uint8 const*)"68x", 4);                     // platform, reversed
+    pkt.append((uint8 const*)"niW", 4);                     // os, reversed
+    pkt.append((uint8 const*)"SUne", 4);                    // country, reversed
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0x0100007F);                              // client ip
+    pkt << uint8(login.size());
+    pkt.append(login.c_str(), login.size());
+
+    Write((char const*)pkt.contents(), pkt.size());
+    ForceFlushOut();
+}
+
+bool AuthClientSocket::ProcessIncomingData()
+{
+    switch (*InPeak())
+    {
+        case CMD_AUTH_LOGON_CHALLENGE: return HandleLogonChallenge();
+        case CMD_AUTH_LOGON_PROOF:     return HandleLogonProof();
+        case CMD_REALM_LIST:           return HandleRealmList();
+        default:
+            m_bot.Fail("unknown realmd packet");
+            return false;
+    }
+}
+
+bool AuthClientSocket::HandleLogonChallenge()
+{
+    // cmd, error, result, B, g length, g, N length, N, s, unk3, security flags
+    uint8 const* data = InPeak();
+    int const length = ReadLengthRemaining();
+
+    if (length < 3)
+        return WaitForData();
+
+    if (data[2] != WOW_SUCCESS)
+    {
+        m_bot.Fail("logon challenge rejected");
+        return false;
+    }
+
+    int const gLenPos = 3 + 32;
+    if (length < gLenPos + 1)
+        return WaitForData();
+
+    int const nLenPos = gLenPos + 1 + data[gLenPos];
+    if (length < nLenPos + 1)
+        return WaitForData();
+
+    int const size = nLenPos + 1 + data[nLenPos] + 32 + 16 + 1;
+    if (length < size)
+        return WaitForData();
+
+    BigNumber B, g, N, s;
+    B.SetBinary(data + 3, 32);
+    g.SetBinary(data + gLenPos + 1, data[gLenPos]);
+    N.SetBinary(data + nLenPos + 1, data[nLenPos]);
+    s.SetBinary(data + nLenPos + 1 + data[nLenPos], 32);
+    uint8 securityFlags = data[size - 1];
+    ReadSkip(size);
+
+    if (securityFlags)
+    {
+        m_bot.Fail("accounts with pin or authenticator are not supported");
+        return false;
+    }
+
+    std::string const& login = m_bot.GetAccountName();
+
+    ///- x = H(s, H(I:P))
+    Sha1Hash sha;
+    sha.UpdateData(login);
+    sha.UpdateData(":");
+    sha.UpdateData(m_bot.GetPassword());
+    sha.Finalize();
+
+    uint8 passHash[SHA_DIGEST_LENGTH];
+    memcpy(passHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&s, nullptr);
+    sha.UpdateData(passHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    ///- A = g^a, u = H(A, B), S = (B - 3 * g^x)^(a + u * x)
+    BigNumber a;
+    a.SetRand(19 * 8);
+    A = g.ModExp(a, N);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, nullptr);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    BigNumber kv = (g.ModExp(x, N) * 3) % N;
+    BigNumber base = (B + N - kv) % N;
+    BigNumber S = base.ModExp(a + u * x, N);
+
+    ///- Session key, same interleaved hash as calculated by realmd
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+    K.SetBinary(vK, 40);
+
+    ///- M = H(H(N) xor H(g), H(I), s, A, B, K)
+    uint8 hash[20];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, nullptr);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, nullptr);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(login);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, nullptr);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &K, nullptr);
+    sha.Finalize();
+    M.SetBinary(sha.GetDigest(), 20);
+
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_PROOF);
+    pkt.append(A.AsByteArray(32), 32);
+    pkt.append(sha.GetDigest(), 20);
+    uint8 crcHash[20] = {};
+    pkt.append(crcHash, 20);
+    pkt << uint8(0);                                        // number of keys
+    pkt << uint8(0);                                        // security flags
+
+    Write((char const*)pkt.contents(), pkt.size());
+    ForceFlushOut();
+    return true;
+}
+
+bool AuthClientSocket::HandleLogonProof()
+{
+    if (ReadLengthRemaining() < 2)
+        return WaitForData();
+
+    if (InPeak()[1] != WOW_SUCCESS)
+    {
+        m_bot.Fail("wrong password");
+        return false;
+    }
+
+    // cmd, error, M2, unk
+    uint8 proof[1 + 1 + 20 + 4];
+    if (!Read((char*)proof, sizeof(proof)))
+        return WaitForData();
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &M, &K, nullptr);
+    sha.Finalize();
+
+    if (memcmp(sha.GetDigest(), proof + 2, 20))
+    {
+        m_bot.Fail("realmd sent an invalid server proof");
+        return false;
+    }
+
+    ByteBuffer pkt;
+    pkt << uint8(CMD_REALM_LIST);
+    pkt << uint32(0);
+
+    Write((char const*)pkt.contents(), pkt.size());
+    ForceFlushOut();
+    return true;
+}
+
+bool AuthClientSocket::HandleRealmList()
+{
+    if (ReadLengthRemaining() < 3)
+        return WaitForData();
+
+    uint16 size = InPeak()[1] | (InPeak()[2] << 8);
+    if (ReadLengthRemaining() < 3 + size)
+        return WaitForData();
+
+    ByteBuffer pkt;
+    pkt.append(InPeak(), 3 + size);
+    ReadSkip(3 + size);
+
+    pkt.read_skip<uint8>();                                 // cmd
+    pkt.read_skip<uint16>();                                // size
+    pkt.read_skip<uint32>();                                // unused
+
+    std::string address;
+    uint8 count = pkt.read<uint8>();
+    for (uint8 i = 0; i < count; ++i)
+    {
+        std::string name, realmAddress;
+        uint8 flags;
+
+        pkt.read_skip<uint32>();                            // icon
+        pkt >> flags;
+        pkt >> name;
+        pkt >> realmAddress;
+        pkt.read_skip<float>();                             // population
+        pkt.read_skip<uint8>();                             // characters
+        pkt.read_skip<uint8>();                             // timezone
+        pkt.read_skip<uint8>();                             // unk
+
+        if (!address.empty() || (!m_bot.GetConfig().realmName.empty() && m_bot.GetConfig().realmName != name))
+            continue;
+
+        if (flags & REALM_FLAG_OFFLINE)
+        {
+            m_bot.Fail("realm is offline");
+            return false;
+        }
+
+        address = realmAddress;
+    }
+
+    if (address.empty())
+    {
+        m_bot.Fail("realm not found in realm list");
+        return false;
+    }
+
+    m_bot.OnRealmLogin(K, address);
+
+    // realm list is all we need from realmd
+    Close();
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+WorldClientSocket::WorldClientSocket(boost::asio::io_service& service, Bot& bot)
+    : Socket(service, [&bot](Socket*) { bot.OnWorldSocketClosed(); }), m_bot(bot), m_useExistingHeader(false)
+{
+}
+
+void WorldClientSocket::SendPacket(WorldPacket const& packet)
+{
+    if (IsClosed())
+        return;
+
+    ClientPktHeader header;
+
+    header.cmd = packet.GetOpcode();
+    EndianConvert(header.cmd);
+
+    header.size = static_cast<uint16>(packet.size() + 4);
+    EndianConvertReverse(header.size);
+
+    m_crypt.EncryptClientSend(reinterpret_cast<uint8*>(&header), sizeof(header));
+
+    if (packet.size() > 0)
+        Write(reinterpret_cast<char const*>(&header), sizeof(header), reinterpret_cast<char const*>(packet.contents()), packet.size());
+    else
+        Write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    ForceFlushOut();
+
+    m_bot.GetStats().AddSent(sizeof(header) + packet.size());
+}
+
+bool WorldClientSocket::ProcessIncomingData()
+{
+    ServerPktHeader header;
+
+    if (m_useExistingHeader)
+    {
+        m_useExistingHeader = false;
+        header = m_existingHeader;
+
+        ReadSkip(sizeof(ServerPktHeader));
+    }
+    else
+    {
+        if (!Read((char*)&header, sizeof(ServerPktHeader)))
+        {
+            errno = EBADMSG;
+            return false;
+        }
+
+        m_crypt.DecryptClientRecv((uint8*)&header, sizeof(ServerPktHeader));
+
+        EndianConvertReverse(header.size);
+        EndianConvert(header.cmd);
+    }
+
+    if (header.size < 2)
+    {
+        m_bot.Fail("mangosd sent a malformed packet");
+        return false;
+    }
+
+    const uint16 validBytesRemaining = header.size - 2;
+
+    // keep the decrypted header until the whole packet is received
+    if (validBytesRemaining > ReadLengthRemaining())
+    {
+        m_useExistingHeader = true;
+        m_existingHeader = header;
+
+        ReadSkip(-static_cast<int>(sizeof(ServerPktHeader)));
+
+        errno = EBADMSG;
+        return false;
+    }
+
+    WorldPacket packet(header.cmd, validBytesRemaining);
+    if (validBytesRemaining)
+    {
+        packet.append(InPeak(), validBytesRemaining);
+        ReadSkip(validBytesRemaining);
+    }
+
+    m_bot.GetStats().AddReceived(sizeof(ServerPktHeader) + validBytesRemaining);
+
+    try
+    {
+        if (packet.GetOpcode() == SMSG_AUTH_CHALLENGE)
+            return HandleAuthChallenge(packet);
+
+        m_bot.HandleWorldPacket(packet);
+    }
+    catch (ByteBufferException&)
+    {
+        m_bot.Fail("failed to parse a mangosd packet");
+        return false;
+    }
+
+    return !IsClosed();
+}
+
+bool WorldClientSocket::HandleAuthChallenge(WorldPacket& packet)
+{
+    uint32 serverSeed;
+    packet >> serverSeed;
+
+    uint32 clientSeed = urand();
+    uint32 t = 0;
+    BigNumber K = m_bot.GetSessionKey();
+
+    Sha1Hash sha;
+    sha.UpdateData(m_bot.GetAccountName());
+    sha.UpdateData((uint8*)&t, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&K, nullptr);
+    sha.Finalize();
+
+    WorldPacket auth(CMSG_AUTH_SESSION, 4 + 4 + m_bot.GetAccountName().size() + 1 + 4 + 20);
+    auth << uint32(CLIENT_BUILD);
+    auth << uint32(0);                                      // server id
+    auth << m_bot.GetAccountName();
+    auth << clientSeed;
+    auth.append(sha.GetDigest(), 20);
+    SendPacket(auth);
+
+    // all following headers are encrypted
+    m_crypt.Init(&K);
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+Bot::Bot(boost::asio::io_service& service, LoadTestConfig const& config, LoadStats& stats, uint32 index)
+    : m_service(service), m_config(config), m_stats(stats), m_state(BOT_IDLE),
+      m_queryTimePending(false), m_auctionListPending(false), m_pingPending(false), m_pingCounter(0), m_lastPing(0), m_updateTimer(service),
+      m_guid(0), m_mapId(0), m_homeX(0.0f), m_homeY(0.0f), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_orientation(0.0f), m_moving(false)
+{
+    m_accountName = config.accountPrefix + std::to_string(config.firstAccount + index);
+    m_password = config.password;
+
+    // client sends account name and password in upper case
+    std::transform(m_accountName.begin(), m_accountName.end(), m_accountName.begin(), ::toupper);
+    std::transform(m_password.begin(), m_password.end(), m_password.begin(), ::toupper);
+
+    // character names may contain letters only
+    m_characterName = "Bot";
+    uint32 nameIndex = config.firstAccount + index;
+    for (int i = 0; i < 5; ++i, nameIndex /= 26)
+        m_characterName += char('a' + nameIndex % 26);
+}
+
+void Bot::Start()
+{
+    SetState(BOT_REALM_LOGIN);
+    m_loginStart = Clock::now();
+
+    m_authSocket = std::make_shared<AuthClientSocket>(m_service, *this);
+    m_authSocket->GetAsioSocket().async_connect(m_config.realmd, [this](boost::system::error_code const& error)
+    {
+        if (m_state != BOT_REALM_LOGIN)
+            return;
+
+        if (error || !m_authSocket->Open())
+        {
+            Fail("cannot connect to realmd");
+            return;
+        }
+
+        m_stats.AddLatency(LATENCY_REALM_CONNECT, MsSince(m_loginStart));
+        m_loginStart = Clock::now();
+        m_authSocket->SendLogonChallenge();
+    });
+}
+
+void Bot::Stop()
+{
+    SetState(BOT_STOPPED);
+
+    m_updateTimer.cancel();
+
+    if (m_authSocket && !m_authSocket->IsClosed())
+        m_authSocket->Close();
+    if (m_worldSocket && !m_worldSocket->IsClosed())
+        m_worldSocket->Close();
+}
+
+void Bot::OnAuthSocketClosed()
+{
+    // realmd connection is closed on purpose after the realm list is received
+    if (m_state == BOT_REALM_LOGIN)
+        Fail("realmd closed the connection");
+}
+
+void Bot::OnWorldSocketClosed()
+{
+    Fail("mangosd closed the connection");
+}
+
+void Bot::Fail(char const* reason)
+{
+    // closing the sockets of stopped or failed bots calls this too
+    if (m_state == BOT_FAILED || m_state == BOT_STOPPED)
+        return;
+
+    sLog.outError("Bot %s: %s", m_accountName.c_str(), reason);
+
+    Stop();
+    SetState(BOT_FAILED);
+}
+
+void Bot::SetState(BotState state)
+{
+    if (m_state == state)
+        return;
+
+    switch (m_state)
+    {
+        case BOT_REALM_LOGIN:
+        case BOT_WORLD_LOGIN: m_stats.ChangeBotCounter(BOTS_CONNECTING, -1); break;
+        case BOT_IN_WORLD:    m_stats.ChangeBotCounter(BOTS_IN_WORLD, -1); break;
+        case BOT_FAILED:      m_stats.ChangeBotCounter(BOTS_FAILED, -1); break;
+        default: break;
+    }
+
+    switch (state)
+    {
+        case BOT_REALM_LOGIN:
+        case BOT_WORLD_LOGIN: m_stats.ChangeBotCounter(BOTS_CONNECTING, 1); break;
+        case BOT_IN_WORLD:    m_stats.ChangeBotCounter(BOTS_IN_WORLD, 1); break;
+        case BOT_FAILED:      m_stats.ChangeBotCounter(BOTS_FAILED, 1); break;
+        default: break;
+    }
+
+    m_state = state;
+}
+
+uint32 Bot::MsSince(Clock::time_point const& start) const
+{
+    return uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+void Bot::OnRealmLogin(BigNumber const& K, std::string const& worldAddress)
+{
+    m_stats.AddLatency(LATENCY_REALM_LOGIN, MsSince(m_loginStart));
+
+    m_sessionKey = K;
+    SetState(BOT_WORLD_LOGIN);
+
+    std::string::size_type pos = worldAddress.rfind(':');
+    if (pos == std::string::npos)
+    {
+        Fail("invalid realm address");
+        return;
+    }
+
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::resolver resolver(m_service);
+    boost::asio::ip::tcp::resolver::iterator endpoint = resolver.resolve(boost::asio::ip::tcp::resolver::query(worldAddress.substr(0, pos), worldAddress.substr(pos + 1)), ec);
+    if (ec || endpoint == boost::asio::ip::tcp::resolver::iterator())
+    {
+        Fail("cannot resolve realm address");
+        return;
+    }
+
+    m_loginStart = Clock::now();
+
+    m_worldSocket = std::make_shared<WorldClientSocket>(m_service, *this);
+    m_worldSocket->GetAsioSocket().async_connect(*endpoint, [this](boost::system::error_code const& error)
+    {
+        if (m_state != BOT_WORLD_LOGIN)
+            return;
+
+        if (error || !m_worldSocket->Open())
+            Fail("cannot connect to mangosd");
+    });
+}
+
+void Bot::HandleWorldPacket(WorldPacket& packet)
+{
+    switch (packet.GetOpcode())
+    {
+        case SMSG_AUTH_RESPONSE:          HandleAuthResponse(packet); break;
+        case SMSG_CHAR_ENUM:              HandleCharEnum(packet); break;
+        case SMSG_CHAR_CREATE:            HandleCharCreate(packet); break;
+        case SMSG_LOGIN_VERIFY_WORLD:     HandleLoginVerifyWorld(packet); break;
+        case SMSG_CHARACTER_LOGIN_FAILED: Fail("character login failed"); break;
+        case SMSG_NEW_WORLD:
+        {
+            packet >> m_mapId >> m_x >> m_y >> m_z >> m_orientation;
+            m_homeX = m_x;
+            m_homeY = m_y;
+            m_worldSocket->SendPacket(WorldPacket(MSG_MOVE_WORLDPORT_ACK, 0));
+            break;
+        }
+        case MSG_MOVE_TELEPORT_ACK:       HandleTeleportAck(packet); break;
+        case SMSG_QUERY_TIME_RESPONSE:
+            if (m_queryTimePending)
+            {
+                m_queryTimePending = false;
+                m_stats.AddLatency(LATENCY_WORLD_RESPONSE, MsSince(m_queryTimeSent));
+            }
+            break;
+        case SMSG_AUCTION_LIST_RESULT:
+            if (m_auctionListPending)
+            {
+                m_auctionListPending = false;
+                m_stats.AddLatency(LATENCY_AUCTION_LIST, MsSince(m_auctionListSent));
+            }
+            break;
+        case SMSG_PONG:
+            if (m_pingPending)
+            {
+                m_pingPending = false;
+                m_lastPing = MsSince(m_pingSent);
+                m_stats.AddLatency(LATENCY_PING, m_lastPing);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Bot::HandleAuthResponse(WorldPacket& packet)
+{
+    uint8 result;
+    packet >> result;
+
+    if (result == AUTH_WAIT_QUEUE)
+        return;                                             // AUTH_OK follows when the queue is passed
+
+    if (result != AUTH_OK)
+    {
+        Fail("world authentication failed");
+        return;
+    }
+
+    m_stats.AddLatency(LATENCY_WORLD_AUTH, MsSince(m_loginStart));
+    m_worldSocket->SendPacket(WorldPacket(CMSG_CHAR_ENUM, 0));
+}
+
+void Bot::HandleCharEnum(WorldPacket& packet)
+{
+    uint8 count;
+    packet >> count;
+
+    if (!count)
+    {
+        WorldPacket data(CMSG_CHAR_CREATE, m_characterName.size() + 1 + 9);
+        data << m_characterName;
+        data << m_config.race;
+        data << m_config.class_;
+        data << uint8(0);                                   // gender
+        data << uint8(0) << uint8(0);                       // skin, face
+        data << uint8(0) << uint8(0) << uint8(0);           // hair style, hair color, facial hair
+        data << uint8(0);                                   // outfit
+        m_worldSocket->SendPacket(data);
+        return;
+    }
+
+    packet >> m_guid;
+
+    m_loginStart = Clock::now();
+
+    WorldPacket data(CMSG_PLAYER_LOGIN, 8);
+    data << m_guid;
+    m_worldSocket->SendPacket(data);
+}
+
+void Bot::HandleCharCreate(WorldPacket& packet)
+{
+    uint8 result;
+    packet >> result;
+
+    if (result != CHAR_CREATE_SUCCESS)
+    {
+        Fail("character creation failed");
+        return;
+    }
+
+    m_worldSocket->SendPacket(WorldPacket(CMSG_CHAR_ENUM, 0));
+}
+
+void Bot::HandleLoginVerifyWorld(WorldPacket& packet)
+{
+    packet >> m_mapId >> m_x >> m_y >> m_z >> m_orientation;
+    m_homeX = m_x;
+    m_homeY = m_y;
+
+    m_stats.AddLatency(LATENCY_ENTER_WORLD, MsSince(m_loginStart));
+    SetState(BOT_IN_WORLD);
+
+    // spread the periodic packets of all bots
+    Clock::time_point now = Clock::now();
+    m_startTime = now;
+    m_nextMove = now + std::chrono::milliseconds(m_config.moveInterval ? urand(0, m_config.moveInterval) : 0);
+    m_nextSpam = now + std::chrono::milliseconds(m_config.spamInterval ? urand(0, m_config.spamInterval) : 0);
+    m_nextPing = now + std::chrono::milliseconds(urand(0, PING_INTERVAL));
+
+    if (!m_config.command.empty())
+        SendCommand();
+
+    ScheduleUpdate();
+}
+
+void Bot::HandleTeleportAck(WorldPacket& packet)
+{
+    // near teleport, e.g. by the start command
+    uint64 guid = packet.readPackGUID();
+    uint32 counter, flags, time;
+    packet >> counter >> flags >> time;
+    packet >> m_x >> m_y >> m_z >> m_orientation;
+    m_homeX = m_x;
+    m_homeY = m_y;
+    m_moving = false;
+
+    WorldPacket data(MSG_MOVE_TELEPORT_ACK, 8 + 4 + 4);
+    data << guid;
+    data << counter;
+    data << uint32(MsSince(m_startTime));
+    m_worldSocket->SendPacket(data);
+}
+
+void Bot::ScheduleUpdate()
+{
+    m_updateTimer.expires_from_now(boost::posix_time::milliseconds(BOT_UPDATE_INTERVAL));
+    m_updateTimer.async_wait([this](boost::system::error_code const& error)
+    {
+        if (error || m_state != BOT_IN_WORLD)
+            return;
+
+        Update();
+        ScheduleUpdate();
+    });
+}
+
+void Bot::Update()
+{
+    Clock::time_point now = Clock::now();
+
+    if (m_config.moveInterval && now >= m_nextMove)
+    {
+        m_nextMove = now + std::chrono::milliseconds(m_config.moveInterval);
+        SendMovement();
+    }
+
+    if (m_config.spamFlags && m_config.spamInterval && now >= m_nextSpam)
+    {
+        m_nextSpam = now + std::chrono::milliseconds(m_config.spamInterval);
+        SendSpam();
+    }
+
+    if (now >= m_nextPing)
+    {
+        m_nextPing = now + std::chrono::milliseconds(PING_INTERVAL);
+        SendPing();
+    }
+}
+
+void Bot::SendMovement()
+{
+    uint16 opcode = MSG_MOVE_HEARTBEAT;
+
+    if (!m_moving)
+    {
+        opcode = MSG_MOVE_START_FORWARD;
+        m_moving = true;
+    }
+    else
+    {
+        float dist = BOT_RUN_SPEED * m_config.moveInterval / IN_MILLISECONDS;
+        m_x += dist * cos(m_orientation);
+        m_y += dist * sin(m_orientation);
+
+        // turn around at the end of the walk range
+        if ((m_x - m_homeX) * (m_x - m_homeX) + (m_y - m_homeY) * (m_y - m_homeY) > BOT_MOVE_RANGE * BOT_MOVE_RANGE)
+        {
+            m_orientation = float(fmod(m_orientation + M_PI_F, 2 * M_PI_F));
+            opcode = MSG_MOVE_SET_FACING;
+        }
+    }
+
+    WorldPacket data(opcode, 4 + 4 + 4 * 4 + 4);
+    data << uint32(MOVEFLAG_FORWARD);
+    data << uint32(MsSince(m_startTime));
+    data << m_x << m_y << m_z << m_orientation;
+    data << uint32(0);                                      // fall time
+    m_worldSocket->SendPacket(data);
+}
+
+void Bot::SendCommand()
+{
+    // commands are said, the account needs the security level of the command
+    WorldPacket data(CMSG_MESSAGECHAT, 4 + 4 + m_config.command.size() + 1);
+    data << uint32(CHAT_MSG_SAY);
+    data << uint32(LANG_UNIVERSAL);
+    data << m_config.command;
+    m_worldSocket->SendPacket(data);
+}
+
+void Bot::SendSpam()
+{
+    if ((m_config.spamFlags & SPAM_QUERY_TIME) && !m_queryTimePending)
+    {
+        m_queryTimePending = true;
+        m_queryTimeSent = Clock::now();
+        m_worldSocket->SendPacket(WorldPacket(CMSG_QUERY_TIME, 0));
+    }
+
+    if (m_config.spamFlags & SPAM_NAME_QUERY)
+    {
+        WorldPacket data(CMSG_NAME_QUERY, 8);
+        data << m_guid;
+        m_worldSocket->SendPacket(data);
+    }
+
+    if (m_config.spamFlags & SPAM_SAY)
+    {
+        WorldPacket data(CMSG_MESSAGECHAT, 4 + 4 + strlen(botChatMessage) + 1);
+        data << uint32(CHAT_MSG_SAY);
+        data << uint32(((1 << (m_config.race - 1)) & RACEMASK_ALLIANCE) ? LANG_COMMON : LANG_ORCISH);
+        data << botChatMessage;
+        m_worldSocket->SendPacket(data);
+    }
+
+    if ((m_config.spamFlags & SPAM_AUCTION_LIST) && !m_auctionListPending)
+    {
+        m_auctionListPending = true;
+        m_auctionListSent = Clock::now();
+
+        // first page of all auctions matching the searched name
+        WorldPacket data(CMSG_AUCTION_LIST_ITEMS, 8 + 4 + m_config.auctionSearch.size() + 1 + 1 + 1 + 4 * 4 + 1);
+        data << m_config.auctioneer;
+        data << uint32(0);                                  // list from
+        data << m_config.auctionSearch;
+        data << uint8(0) << uint8(0);                       // level min, level max
+        data << uint32(0xffffffff);                         // inventory type
+        data << uint32(0xffffffff);                         // item class
+        data << uint32(0xffffffff);                         // item subclass
+        data << uint32(0xffffffff);                         // quality
+        data << uint8(0);                                   // usable
+        m_worldSocket->SendPacket(data);
+    }
+}
+
+void Bot::SendPing()
+{
+    m_pingPending = true;
+    m_pingSent = Clock::now();
+
+    WorldPacket data(CMSG_PING, 8);
+    data << uint32(++m_pingCounter);
+    data << uint32(m_lastPing);
+    m_worldSocket->SendPacket(data);
+}
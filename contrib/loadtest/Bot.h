@@ -0,0 +1,217 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LOADTEST_BOT_H
+#define _LOADTEST_BOT_H
+
+#include "Common.h"
+#include "Auth/AuthCrypt.h"
+#include "Auth/BigNumber.h"
+#include "Network/Socket.hpp"
+#include "WorldPacket.h"
+#include "LoadStats.h"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+/// Packets sent periodically by bots in world
+enum SpamFlags
+{
+    SPAM_QUERY_TIME             = 0x01,                     // CMSG_QUERY_TIME, used for the world response latency
+    SPAM_NAME_QUERY             = 0x02,                     // CMSG_NAME_QUERY of the own character
+    SPAM_SAY                    = 0x04,                     // CMSG_MESSAGECHAT say message
+    SPAM_AUCTION_LIST           = 0x08,                     // CMSG_AUCTION_LIST_ITEMS at the configured auctioneer
+};
+
+struct LoadTestConfig
+{
+    boost::asio::ip::tcp::endpoint realmd;
+    std::string realmName;                                  // empty to use the first realm of the list
+    std::string accountPrefix;
+    std::string password;
+    uint32 firstAccount;
+    uint8 race;
+    uint8 class_;
+    uint32 moveInterval;                                    // ms between movement packets, 0 to stand still
+    uint32 spamFlags;                                       // SpamFlags
+    uint32 spamInterval;
+    std::string command;                                    // chat command sent once after entering the world, empty for none
+    uint64 auctioneer;                                      // guid of the auctioneer of SPAM_AUCTION_LIST
+    std::string auctionSearch;                              // searched item name of SPAM_AUCTION_LIST
+};
+
+class Bot;
+
+/// Connection to realmd: SRP6 logon and realm list
+class AuthClientSocket : public MaNGOS::Socket
+{
+    public:
+        AuthClientSocket(boost::asio::io_service& service, Bot& bot);
+
+        void SendLogonChallenge();
+
+    private:
+        bool HandleLogonChallenge();
+        bool HandleLogonProof();
+        bool HandleRealmList();
+
+        // waits for more data of the current packet
+        bool WaitForData() { errno = EBADMSG; return false; }
+
+        virtual bool ProcessIncomingData() override;
+
+        Bot& m_bot;
+        BigNumber A, M, K;
+};
+
+/// Connection to mangosd
+class WorldClientSocket : public MaNGOS::Socket
+{
+    public:
+        WorldClientSocket(boost::asio::io_service& service, Bot& bot);
+
+        void SendPacket(WorldPacket const& packet);
+
+    private:
+#if defined( __GNUC__ )
+#pragma pack(1)
+#else
+#pragma pack(push,1)
+#endif
+        struct ServerPktHeader
+        {
+            uint16 size;
+            uint16 cmd;
+        };
+
+        struct ClientPktHeader
+        {
+            uint16 size;
+            uint32 cmd;
+        };
+#if defined( __GNUC__ )
+#pragma pack()
+#else
+#pragma pack(pop)
+#endif
+
+        bool HandleAuthChallenge(WorldPacket& packet);
+
+        virtual bool ProcessIncomingData() override;
+
+        Bot& m_bot;
+        AuthCrypt m_crypt;
+
+        // header of a packet which is not completely received yet, already decrypted
+        bool m_useExistingHeader;
+        ServerPktHeader m_existingHeader;
+};
+
+/// One synthetic client, all its handlers run in the network thread of its io_service
+class Bot
+{
+    public:
+        Bot(boost::asio::io_service& service, LoadTestConfig const& config, LoadStats& stats, uint32 index);
+
+        void Start();
+        void Stop();
+
+        std::string const& GetAccountName() const { return m_accountName; }
+        std::string const& GetPassword() const { return m_password; }
+        LoadTestConfig const& GetConfig() const { return m_config; }
+        LoadStats& GetStats() { return m_stats; }
+
+        // auth connection
+        void OnRealmLogin(BigNumber const& K, std::string const& worldAddress);
+        void OnAuthSocketClosed();
+        BigNumber const& GetSessionKey() const { return m_sessionKey; }
+
+        // world connection
+        void HandleWorldPacket(WorldPacket& packet);
+        void OnWorldSocketClosed();
+
+        void Fail(char const* reason);
+
+    private:
+        enum BotState
+        {
+            BOT_IDLE,
+            BOT_REALM_LOGIN,
+            BOT_WORLD_LOGIN,
+            BOT_IN_WORLD,
+            BOT_FAILED,
+            BOT_STOPPED
+        };
+
+        typedef std::chrono::steady_clock Clock;
+
+        void SetState(BotState state);
+        uint32 MsSince(Clock::time_point const& start) const;
+
+        void HandleAuthResponse(WorldPacket& packet);
+        void HandleCharEnum(WorldPacket& packet);
+        void HandleCharCreate(WorldPacket& packet);
+        void HandleLoginVerifyWorld(WorldPacket& packet);
+        void HandleTeleportAck(WorldPacket& packet);
+
+        void ScheduleUpdate();
+        void Update();
+        void SendMovement();
+        void SendCommand();
+        void SendSpam();
+        void SendPing();
+
+        boost::asio::io_service& m_service;
+        LoadTestConfig const& m_config;
+        LoadStats& m_stats;
+
+        std::string m_accountName;
+        std::string m_password;
+        std::string m_characterName;
+
+        BotState m_state;
+        std::shared_ptr<AuthClientSocket> m_authSocket;
+        std::shared_ptr<WorldClientSocket> m_worldSocket;
+        BigNumber m_sessionKey;
+
+        Clock::time_point m_loginStart;
+        Clock::time_point m_queryTimeSent;
+        Clock::time_point m_auctionListSent;
+        Clock::time_point m_pingSent;
+        bool m_queryTimePending;
+        bool m_auctionListPending;
+        bool m_pingPending;
+        uint32 m_pingCounter;
+        uint32 m_lastPing;
+
+        boost::asio::deadline_timer m_updateTimer;
+        Clock::time_point m_nextMove;
+        Clock::time_point m_nextSpam;
+        Clock::time_point m_nextPing;
+
+        uint64 m_guid;
+        uint32 m_mapId;
+        float m_homeX, m_homeY, m_x, m_y, m_z, m_orientation;
+        bool m_moving;
+        Clock::time_point m_startTime;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadStats.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static char const* latencyNames[MAX_LATENCY_TYPE] =
+{
+    "realm connect",
+    "realm login",
+    "world auth",
+    "enter world",
+    "world response",
+    "ping",
+    "auction list",
+};
+
+void LatencySamples::Add(uint32 ms)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_interval.push_back(ms);
+}
+
+std::vector<uint32> LatencySamples::TakeInterval()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::vector<uint32> samples;
+    samples.swap(m_interval);
+    m_total.insert(m_total.end(), samples.begin(), samples.end());
+    return samples;
+}
+
+std::vector<uint32> LatencySamples::GetTotal() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::vector<uint32> samples(m_total);
+    samples.insert(samples.end(), m_interval.begin(), m_interval.end());
+    return samples;
+}
+
+LoadStats::LoadStats() : m_sentPackets(0), m_sentBytes(0), m_recvPackets(0), m_recvBytes(0),
+    m_lastSentPackets(0), m_lastSentBytes(0), m_lastRecvPackets(0), m_lastRecvBytes(0)
+{
+    for (int i = 0; i < MAX_BOT_COUNTER; ++i)
+        m_bots[i] = 0;
+}
+
+static uint32 Percentile(std::vector<uint32> const& sorted, uint32 percent)
+{
+    return sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * percent / 100)];
+}
+
+std::string LoadStats::FormatLatency(std::vector<uint32>& samples)
+{
+    if (samples.empty())
+        return "-";
+
+    std::sort(samples.begin(), samples.end());
+
+    char buf[96];
+    snprintf(buf, sizeof(buf), "p50 %u p95 %u p99 %u max %u ms (" SIZEFMTD ")",
+             Percentile(samples, 50), Percentile(samples, 95), Percentile(samples, 99), samples.back(), samples.size());
+    return buf;
+}
+
+void LoadStats::ReportInterval(uint32 elapsed, uint32 diff, uint32 botCount)
+{
+    uint64 sentPackets = m_sentPackets, sentBytes = m_sentBytes;
+    uint64 recvPackets = m_recvPackets, recvBytes = m_recvBytes;
+    float seconds = diff ? diff / float(IN_MILLISECONDS) : 1.0f;
+
+    sLog.outString("[%5us] bots: %d in world, %d connecting, %d failed of %u | sent %.0f pkt/s %.1f KB/s | received %.0f pkt/s %.1f KB/s",
+                   elapsed / IN_MILLISECONDS, GetBotCounter(BOTS_IN_WORLD), GetBotCounter(BOTS_CONNECTING), GetBotCounter(BOTS_FAILED), botCount,
+                   (sentPackets - m_lastSentPackets) / seconds, (sentBytes - m_lastSentBytes) / seconds / 1024.0f,
+                   (recvPackets - m_lastRecvPackets) / seconds, (recvBytes - m_lastRecvBytes) / seconds / 1024.0f);
+
+    m_lastSentPackets = sentPackets;
+    m_lastSentBytes = sentBytes;
+    m_lastRecvPackets = recvPackets;
+    m_lastRecvBytes = recvBytes;
+
+    std::vector<uint32> world, ping;
+    for (int i = 0; i < MAX_LATENCY_TYPE; ++i)
+    {
+        std::vector<uint32> samples = m_latency[i].TakeInterval();
+        if (samples.empty())
+            continue;
+
+        if (i == LATENCY_WORLD_RESPONSE)
+            world = samples;
+        else if (i == LATENCY_PING)
+            ping = samples;
+
+        sLog.outString("        %-15s %s", latencyNames[i], FormatLatency(samples).c_str());
+    }
+
+    // world responses wait for the next world update, pings are answered by the network thread
+    // so the difference of both is about the time the world update needs
+    if (!world.empty() && !ping.empty())
+    {
+        std::sort(world.begin(), world.end());
+        std::sort(ping.begin(), ping.end());
+        int32 tick = int32(Percentile(world, 50)) - int32(Percentile(ping, 50));
+        sLog.outString("        %-15s ~%d ms", "world tick", std::max(tick, 0));
+    }
+}
+
+void LoadStats::ReportTotal(uint32 elapsed)
+{
+    float seconds = elapsed ? elapsed / float(IN_MILLISECONDS) : 1.0f;
+
+    sLog.outString("Total after %u seconds: sent " UI64FMTD " packets (%.0f pkt/s), received " UI64FMTD " packets (%.0f pkt/s), %d bots failed",
+                   elapsed / IN_MILLISECONDS, uint64(m_sentPackets), m_sentPackets / seconds, uint64(m_recvPackets), m_recvPackets / seconds, GetBotCounter(BOTS_FAILED));
+
+    for (int i = 0; i < MAX_LATENCY_TYPE; ++i)
+    {
+        std::vector<uint32> samples = m_latency[i].GetTotal();
+        sLog.outString("        %-15s %s", latencyNames[i], FormatLatency(samples).c_str());
+    }
+}
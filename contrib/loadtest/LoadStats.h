@@ -0,0 +1,102 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LOADSTATS_H
+#define _LOADSTATS_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/// Latencies measured by the bots
+enum LatencyType
+{
+    LATENCY_REALM_CONNECT       = 0,                        // tcp connect to realmd
+    LATENCY_REALM_LOGIN         = 1,                        // logon challenge sent -> realm list received
+    LATENCY_WORLD_AUTH          = 2,                        // world connect -> SMSG_AUTH_RESPONSE
+    LATENCY_ENTER_WORLD         = 3,                        // CMSG_PLAYER_LOGIN -> SMSG_LOGIN_VERIFY_WORLD
+    LATENCY_WORLD_RESPONSE      = 4,                        // CMSG_QUERY_TIME round trip, handled in the world update
+    LATENCY_PING                = 5,                        // CMSG_PING round trip, handled in the network thread
+    LATENCY_AUCTION_LIST        = 6,                        // CMSG_AUCTION_LIST_ITEMS -> SMSG_AUCTION_LIST_RESULT
+    MAX_LATENCY_TYPE
+};
+
+/// Bot state counters
+enum BotCounter
+{
+    BOTS_CONNECTING             = 0,                        // realm login or world login in progress
+    BOTS_IN_WORLD               = 1,
+    BOTS_FAILED                 = 2,                        // login failed or connection lost
+    MAX_BOT_COUNTER
+};
+
+/// Collected samples of one latency type
+class LatencySamples
+{
+    public:
+        void Add(uint32 ms);
+
+        // moves the samples of the last interval to the total ones and returns them
+        std::vector<uint32> TakeInterval();
+        std::vector<uint32> GetTotal() const;
+
+    private:
+        mutable std::mutex m_lock;
+        std::vector<uint32> m_interval;
+        std::vector<uint32> m_total;
+};
+
+/// Counters shared by all bots, written from all network threads
+class LoadStats
+{
+    public:
+        LoadStats();
+
+        void AddLatency(LatencyType type, uint32 ms) { m_latency[type].Add(ms); }
+
+        void ChangeBotCounter(BotCounter counter, int32 diff) { m_bots[counter] += diff; }
+        int32 GetBotCounter(BotCounter counter) const { return m_bots[counter]; }
+
+        void AddSent(uint32 bytes) { ++m_sentPackets; m_sentBytes += bytes; }
+        void AddReceived(uint32 bytes) { ++m_recvPackets; m_recvBytes += bytes; }
+
+        // prints the state of the last interval of length diff ms
+        void ReportInterval(uint32 elapsed, uint32 diff, uint32 botCount);
+        void ReportTotal(uint32 elapsed);
+
+    private:
+        static std::string FormatLatency(std::vector<uint32>& samples);
+
+        LatencySamples m_latency[MAX_LATENCY_TYPE];
+        std::atomic<int32> m_bots[MAX_BOT_COUNTER];
+
+        std::atomic<uint64> m_sentPackets;
+        std::atomic<uint64> m_sentBytes;
+        std::atomic<uint64> m_recvPackets;
+        std::atomic<uint64> m_recvBytes;
+
+        // totals at the end of the last reported interval
+        uint64 m_lastSentPackets;
+        uint64 m_lastSentBytes;
+        uint64 m_lastRecvPackets;
+        uint64 m_lastRecvBytes;
+};
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// Synthetic clients for load tests of realmd and mangosd
+
+#include "Common.h"
+#include "Database/DatabaseEnv.h"
+#include "Auth/Sha1.h"
+#include "Log.h"
+#include "Util.h"
+#include "Bot.h"
+#include "LoadStats.h"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+DatabaseType LoginDatabase;                                 ///< Only used to create the bot accounts
+
+static std::atomic<bool> stopEvent(false);
+
+static void OnSignal(int)
+{
+    stopEvent = true;
+}
+
+/// Creates the missing bot accounts in the realmd database
+static bool CreateAccounts(std::string const& dbInfo, LoadTestConfig const& config, uint32 count)
+{
+    if (!LoginDatabase.Initialize(dbInfo.c_str()))
+    {
+        sLog.outError("Cannot connect to the login database");
+        return false;
+    }
+
+    std::string password = config.password;
+    std::transform(password.begin(), password.end(), password.begin(), ::toupper);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        std::string name = config.accountPrefix + std::to_string(config.firstAccount + i);
+        std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+        LoginDatabase.escape_string(name);
+
+        Sha1Hash sha;
+        sha.UpdateData(name);
+        sha.UpdateData(":");
+        sha.UpdateData(password);
+        sha.Finalize();
+
+        std::string passHash;
+        hexEncodeByteArray(sha.GetDigest(), sha.GetLength(), passHash);
+
+        LoginDatabase.DirectPExecute("INSERT IGNORE INTO account (username, sha_pass_hash, joindate) VALUES ('%s', '%s', NOW())", name.c_str(), passHash.c_str());
+    }
+
+    LoginDatabase.DirectExecute("INSERT INTO realmcharacters (realmid, acctid, numchars) SELECT realmlist.id, account.id, 0 FROM realmlist, account LEFT JOIN realmcharacters ON acctid = account.id WHERE acctid IS NULL");
+    LoginDatabase.HaltDelayThread();
+
+    sLog.outString("Bot accounts %s%u - %s%u are ready", config.accountPrefix.c_str(), config.firstAccount,
+                   config.accountPrefix.c_str(), config.firstAccount + count - 1);
+    return true;
+}
+
+static uint32 ParseSpamFlags(std::string const& list)
+{
+    uint32 flags = 0;
+
+    Tokens tokens = StrSplit(list, ",");
+    for (Tokens::const_iterator itr = tokens.begin(); itr != tokens.end(); ++itr)
+    {
+        if (*itr == "time")
+            flags |= SPAM_QUERY_TIME;
+        else if (*itr == "name")
+            flags |= SPAM_NAME_QUERY;
+        else if (*itr == "say")
+            flags |= SPAM_SAY;
+        else if (*itr == "auction")
+            flags |= SPAM_AUCTION_LIST;
+        else if (*itr != "none")
+            sLog.outError("Unknown spam packet '%s' ignored", itr->c_str());
+    }
+
+    return flags;
+}
+
+int main(int argc, char* argv[])
+{
+    LoadTestConfig config;
+    std::string realmd, spam, loginDatabase, auctioneer;
+    uint32 botCount, connectRate, duration, threadCount, reportInterval, race, class_;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+        ("help,h", "print usage and exit")
+        ("realmd,r", boost::program_options::value<std::string>(&realmd)->default_value("127.0.0.1:3724"), "realmd address")
+        ("realm", boost::program_options::value<std::string>(&config.realmName), "realm to log in, default the first one of the realm list")
+        ("bots,n", boost::program_options::value<uint32>(&botCount)->default_value(10), "number of bots")
+        ("prefix", boost::program_options::value<std::string>(&config.accountPrefix)->default_value("loadbot"), "bot account name prefix, followed by the bot number")
+        ("first", boost::program_options::value<uint32>(&config.firstAccount)->default_value(1), "number of the first bot account")
+        ("password", boost::program_options::value<std::string>(&config.password)->default_value("loadbot"), "password of all bot accounts")
+        ("create-accounts", boost::program_options::value<std::string>(&loginDatabase), "create missing bot accounts in this realmd database (LoginDatabaseInfo format)")
+        ("race", boost::program_options::value<uint32>(&race)->default_value(RACE_HUMAN), "race of created characters")
+        ("class", boost::program_options::value<uint32>(&class_)->default_value(CLASS_WARRIOR), "class of created characters")
+        ("rate", boost::program_options::value<uint32>(&connectRate)->default_value(50), "bots started per second, 0 to start all at once")
+        ("duration,d", boost::program_options::value<uint32>(&duration)->default_value(60), "test duration in seconds, 0 to run until stopped")
+        ("threads,t", boost::program_options::value<uint32>(&threadCount)->default_value(2), "network threads")
+        ("move", boost::program_options::value<uint32>(&config.moveInterval)->default_value(500), "ms between movement packets, 0 to stand still")
+        ("spam", boost::program_options::value<std::string>(&spam)->default_value("time"), "packets sent periodically: time, name, say, auction or none")
+        ("spam-interval", boost::program_options::value<uint32>(&config.spamInterval)->default_value(1000), "ms between spam packets")
+        ("command", boost::program_options::value<std::string>(&config.command), "chat command said once after entering the world, e.g. to teleport the bots")
+        ("auctioneer", boost::program_options::value<std::string>(&auctioneer), "guid of the auctioneer searched by the auction spam")
+        ("auction-search", boost::program_options::value<std::string>(&config.auctionSearch), "item name searched by the auction spam, empty to list all auctions")
+        ("report", boost::program_options::value<uint32>(&reportInterval)->default_value(10), "seconds between reports");
+
+    boost::program_options::variables_map vm;
+
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (!botCount || !threadCount)
+    {
+        sLog.outError("At least one bot and one thread are needed");
+        return 1;
+    }
+
+    config.race = uint8(race);
+    config.class_ = uint8(class_);
+    config.spamFlags = ParseSpamFlags(spam);
+    config.auctioneer = auctioneer.empty() ? 0 : strtoull(auctioneer.c_str(), nullptr, 0);
+
+    if ((config.spamFlags & SPAM_AUCTION_LIST) && !config.auctioneer)
+    {
+        sLog.outError("The auction spam needs the --auctioneer guid");
+        return 1;
+    }
+
+    std::string::size_type pos = realmd.rfind(':');
+    boost::system::error_code ec;
+    boost::asio::ip::address address = boost::asio::ip::address::from_string(realmd.substr(0, pos), ec);
+    if (ec || pos == std::string::npos)
+    {
+        sLog.outError("Invalid realmd address %s, expected ip:port", realmd.c_str());
+        return 1;
+    }
+    config.realmd = boost::asio::ip::tcp::endpoint(address, uint16(atoi(realmd.substr(pos + 1).c_str())));
+
+    if (!loginDatabase.empty() && !CreateAccounts(loginDatabase, config, botCount))
+        return 1;
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    ///- One io_service per network thread, so all handlers of one bot run in the same thread
+    std::vector<std::unique_ptr<boost::asio::io_service> > services;
+    std::vector<std::unique_ptr<boost::asio::io_service::work> > works;
+    std::vector<std::thread> threads;
+    for (uint32 i = 0; i < threadCount; ++i)
+    {
+        services.emplace_back(new boost::asio::io_service());
+        works.emplace_back(new boost::asio::io_service::work(*services.back()));
+    }
+    for (uint32 i = 0; i < threadCount; ++i)
+        threads.emplace_back([&services, i]() { services[i]->run(); });
+
+    LoadStats stats;
+    std::vector<std::unique_ptr<Bot> > bots;
+    bots.reserve(botCount);
+    for (uint32 i = 0; i < botCount; ++i)
+        bots.emplace_back(new Bot(*services[i % threadCount], config, stats, i));
+
+    sLog.outString("Starting %u bots on %s with %u threads", botCount, realmd.c_str(), threadCount);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point const start = Clock::now();
+    Clock::time_point lastReport = start;
+    uint32 started = 0;
+
+    while (!stopEvent)
+    {
+        Clock::time_point now = Clock::now();
+        uint32 elapsed = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+
+        if (duration && elapsed >= duration * IN_MILLISECONDS)
+            break;
+
+        ///- Start bots at the configured rate
+        uint32 toStart = connectRate ? std::min<uint64>(botCount, uint64(elapsed) * connectRate / IN_MILLISECONDS + 1) : botCount;
+        for (; started < toStart; ++started)
+        {
+            Bot* bot = bots[started].get();
+            services[started % threadCount]->post([bot]() { bot->Start(); });
+        }
+
+        uint32 sinceReport = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(now - lastReport).count());
+        if (sinceReport >= reportInterval * IN_MILLISECONDS)
+        {
+            stats.ReportInterval(elapsed, sinceReport, started);
+            lastReport = now;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    ///- Disconnect all bots in their network threads and wait for the threads
+    for (uint32 i = 0; i < botCount; ++i)
+    {
+        Bot* bot = bots[i].get();
+        services[i % threadCount]->post([bot]() { bot->Stop(); });
+    }
+
+    works.clear();
+    for (uint32 i = 0; i < threadCount; ++i)
+        threads[i].join();
+
+    stats.ReportTotal(uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count()));
+    return 0;
+}
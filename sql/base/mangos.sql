@@ -23,7 +23,7 @@ DROP TABLE IF EXISTS `db_version`;
 CREATE TABLE `db_version` (
   `version` varchar(120) DEFAULT NULL,
   `creature_ai_version` varchar(120) DEFAULT NULL,
-  `required_z2717_01_mangos_spam_records_length` bit(1) DEFAULT NULL
+  `required_z2718_01_mangos_command` bit(1) DEFAULT NULL
 ) ENGINE=MyISAM DEFAULT CHARSET=utf8 ROW_FORMAT=DYNAMIC COMMENT='Used DB version notes';
 
 --
@@ -640,6 +640,9 @@ INSERT INTO `command` VALUES
 ('server set motd',3,'Syntax: .server set motd $MOTD\r\n\r\nSet server Message of the day.'),
 ('server shutdown',3,'Syntax: .server shutdown #delay [#exit_code]\r\n\r\nShut the server down after #delay seconds. Use #exit_code or 0 as program exit code.'),
 ('server shutdown cancel',3,'Syntax: .server shutdown cancel\r\n\r\nCancel the restart/shutdown timer if any.'),
+('server tickstats',2,'Syntax: .server tickstats [#maps]\r\n\r\nShow last/p50/p99/max times of the world update phases and of the #maps (default 10) slowest maps over the recent ticks.'),
+('server tickstats dump',3,'Syntax: .server tickstats dump [$filename]\r\n\r\nWrite the tick statistics of all maps into $filename (or a timestamped file) in the logs directory.'),
+('server tickstats reset',3,'Syntax: .server tickstats reset\r\n\r\nClear the collected tick statistics.'),
 ('setskill',3,'Syntax: .setskill #skill #level [#max]\r\n\r\nSet a skill of id #skill with a current skill value of #level and a maximum value of #max (or equal current maximum if not provide) for the selected character. If no character is selected, you learn the skill.'),
 ('showarea',3,'Syntax: .showarea #areaid\r\n\r\nReveal the area of #areaid to the selected character. If no character is selected, reveal this area to you.'),
 ('stable',3,'Syntax: .stable\r\n\r\nShow your pet stable.'),
@@ -0,0 +1,7 @@
+ALTER TABLE db_version CHANGE COLUMN required_z2717_01_mangos_spam_records_length required_z2718_01_mangos_command bit;
+
+DELETE FROM command WHERE name IN ('server tickstats','server tickstats dump','server tickstats reset');
+INSERT INTO command (name, security, help) VALUES
+('server tickstats',2,'Syntax: .server tickstats [#maps]\r\n\r\nShow last/p50/p99/max times of the world update phases and of the #maps (default 10) slowest maps over the recent ticks.'),
+('server tickstats dump',3,'Syntax: .server tickstats dump [$filename]\r\n\r\nWrite the tick statistics of all maps into $filename (or a timestamped file) in the logs directory.'),
+('server tickstats reset',3,'Syntax: .server tickstats reset\r\n\r\nClear the collected tick statistics.');
@@ -95,6 +95,22 @@ class Grid
             return m_activeGridObjects.size() + i_objects.template Count<ACTIVE_OBJECT>();
         }
 
+        /** Returns the number of world objects of the given type within the grid.
+         */
+        template<class SPECIFIC_OBJECT>
+        uint32 WorldObjectCount() const
+        {
+            return i_objects.template Count<SPECIFIC_OBJECT>();
+        }
+
+        /** Returns the number of container type objects of the given type within the grid.
+         */
+        template<class SPECIFIC_OBJECT>
+        uint32 GridObjectCount() const
+        {
+            return i_container.template Count<SPECIFIC_OBJECT>();
+        }
+
         /** Inserts a container type object into the grid.
          */
         template<class SPECIFIC_OBJECT>
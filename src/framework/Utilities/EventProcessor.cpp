@@ -18,9 +18,35 @@
 
 #include "EventProcessor.h"
 
+#include <cstring>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define EVENT_WHEEL_SLOT_MASK   (EVENT_WHEEL_SLOTS - 1)
+
+static inline uint32 FirstSetSlot(uint32 slots)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, slots);
+    return index;
+#else
+    return __builtin_ctz(slots);
+#endif
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_wheelTime = 0;
+    m_nextEventTime = UINT64_MAX;
+    m_overflow = nullptr;
+    m_readyHead = nullptr;
+    m_readyTail = nullptr;
+    m_freeNodes = nullptr;
     m_aborting = false;
 }
 
@@ -34,27 +60,53 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // most updates of most processors have nothing to do, the wheel catches up with the time when an event is due
+    if (!m_readyHead && m_time < m_nextEventTime)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        // without events it can jump right away, so new events don't land in the overflow list
+        if (m_nextEventTime == UINT64_MAX)
+            m_wheelTime = m_time;
+        return;
+    }
 
-        if (!Event->to_Abort)
+    // main event loop
+    for (;;)
+    {
+        if (EventNode* node = m_readyHead)
         {
-            if (Event->Execute(m_time, p_time))
+            // get and remove event from queue
+            m_readyHead = node->next;
+            if (!m_readyHead)
+                m_readyTail = nullptr;
+
+            BasicEvent* Event = node->event;
+            FreeNode(node);
+
+            if (!Event->to_Abort)
             {
-                // completely destroy event if it is not re-added
+                if (Event->Execute(m_time, p_time))
+                {
+                    // completely destroy event if it is not re-added
+                    delete Event;
+                }
+            }
+            else
+            {
+                Event->Abort(m_time);
                 delete Event;
             }
+            continue;
         }
-        else
+
+        // move the wheel to the next event, due events get moved to the ready list
+        uint64 nextTime = GetNextEventTime();
+        if (nextTime > m_time)
         {
-            Event->Abort(m_time);
-            delete Event;
+            m_nextEventTime = nextTime;
+            break;
         }
+
+        AdvanceTo(nextTime);
     }
 }
 
@@ -63,26 +115,23 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // first, abort all existing events, events added meanwhile are queued as usual
+    EventNode* list = DetachAll();
+    while (list)
     {
-        EventList::iterator i_old = i;
-        ++i;
+        EventNode* node = list;
+        list = list->next;
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        node->event->to_Abort = true;
+        node->event->Abort(m_time);
+        if (force || node->event->IsDeletable())
         {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            delete node->event;
+            FreeNode(node);
         }
+        else                                                // keep for deletion at next update
+            Schedule(node);
     }
-
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -91,10 +140,206 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+
+    EventNode* node = AllocateNode();
+    node->event = Event;
+    node->time = e_time;
+    Schedule(node);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+EventProcessor::EventNode* EventProcessor::AllocateNode()
+{
+    if (!m_freeNodes)
+    {
+        EventNode* block = new EventNode[EVENT_NODE_BLOCK_SIZE];
+        m_nodeBlocks.emplace_back(block);
+
+        for (uint32 i = 0; i < EVENT_NODE_BLOCK_SIZE; ++i)
+            FreeNode(&block[i]);
+    }
+
+    EventNode* node = m_freeNodes;
+    m_freeNodes = node->next;
+    return node;
+}
+
+void EventProcessor::FreeNode(EventNode* node)
+{
+    node->next = m_freeNodes;
+    m_freeNodes = node;
+}
+
+void EventProcessor::Schedule(EventNode* node)
+{
+    node->next = nullptr;
+
+    if (node->time < m_nextEventTime)
+        m_nextEventTime = node->time;
+
+    if (node->time <= m_wheelTime)
+    {
+        if (m_readyTail)
+            m_readyTail->next = node;
+        else
+            m_readyHead = node;
+
+        m_readyTail = node;
+        return;
+    }
+
+    // the highest time bits which differ from the wheel time select the level
+    uint64 diff = node->time ^ m_wheelTime;
+    if (diff >> (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS))
+    {
+        node->next = m_overflow;
+        m_overflow = node;
+        return;
+    }
+
+    if (!m_wheel)
+    {
+        m_wheel.reset(new EventWheel);
+        memset(m_wheel.get(), 0, sizeof(EventWheel));
+    }
+
+    uint32 level = 0;
+    while (diff >> (EVENT_WHEEL_BITS * (level + 1)))
+        ++level;
+
+    uint32 slot = uint32(node->time >> (EVENT_WHEEL_BITS * level)) & EVENT_WHEEL_SLOT_MASK;
+    node->next = m_wheel->slots[level][slot];
+    m_wheel->slots[level][slot] = node;
+    m_wheel->usedSlots[level] |= 1u << slot;
+}
+
+uint64 EventProcessor::GetNextEventTime() const
+{
+    if (m_wheel)
+    {
+        for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+        {
+            uint32 shift = EVENT_WHEEL_BITS * level;
+            uint32 current = uint32(m_wheelTime >> shift) & EVENT_WHEEL_SLOT_MASK;
+            if (current == EVENT_WHEEL_SLOT_MASK)
+                continue;
+
+            // only slots after the current one can be used
+            uint32 slots = m_wheel->usedSlots[level] & (~0u << (current + 1));
+            if (!slots)
+                continue;
+
+            // the first used slot holds the next events, all later ones are in later slots or levels
+            uint64 nextTime = UINT64_MAX;
+            for (EventNode* node = m_wheel->slots[level][FirstSetSlot(slots)]; node; node = node->next)
+                if (node->time < nextTime)
+                    nextTime = node->time;
+
+            return nextTime;
+        }
+    }
+
+    uint64 nextTime = UINT64_MAX;
+    for (EventNode* node = m_overflow; node; node = node->next)
+        if (node->time < nextTime)
+            nextTime = node->time;
+
+    return nextTime;
+}
+
+void EventProcessor::AdvanceTo(uint64 time)
+{
+    uint64 oldTime = m_wheelTime;
+    if (time <= oldTime)
+        return;
+
+    m_wheelTime = time;
+
+    // events of the overflow list may be in range of the wheel now
+    if ((time >> (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS)) != (oldTime >> (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS)))
+    {
+        EventNode* list = ReverseList(m_overflow);
+        m_overflow = nullptr;
+        while (list)
+        {
+            EventNode* node = list;
+            list = list->next;
+            Schedule(node);
+        }
+    }
+
+    if (!m_wheel)
+        return;
+
+    // from top to bottom: events of the slot the new time is in move to lower levels or to the ready list
+    for (int32 level = EVENT_WHEEL_LEVELS - 1; level >= 0; --level)
+    {
+        uint32 shift = EVENT_WHEEL_BITS * level;
+        if ((time >> shift) == (oldTime >> shift))
+            continue;
+
+        uint32 slot = uint32(time >> shift) & EVENT_WHEEL_SLOT_MASK;
+        EventNode* list = ReverseList(m_wheel->slots[level][slot]);
+        m_wheel->slots[level][slot] = nullptr;
+        m_wheel->usedSlots[level] &= ~(1u << slot);
+
+        while (list)
+        {
+            EventNode* node = list;
+            list = list->next;
+            Schedule(node);
+        }
+    }
+}
+
+EventProcessor::EventNode* EventProcessor::ReverseList(EventNode* list)
+{
+    EventNode* reversed = nullptr;
+    while (list)
+    {
+        EventNode* next = list->next;
+        list->next = reversed;
+        reversed = list;
+        list = next;
+    }
+    return reversed;
+}
+
+EventProcessor::EventNode* EventProcessor::DetachAll()
+{
+    EventNode* list = m_readyHead;
+    if (m_readyTail)
+        m_readyTail->next = m_overflow;
+    else
+        list = m_overflow;
+
+    m_readyHead = nullptr;
+    m_readyTail = nullptr;
+    m_overflow = nullptr;
+
+    if (m_wheel)
+    {
+        for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+        {
+            for (uint32 slots = m_wheel->usedSlots[level]; slots; slots &= slots - 1)
+            {
+                uint32 slot = FirstSetSlot(slots);
+                EventNode* node = m_wheel->slots[level][slot];
+                while (node->next)
+                    node = node->next;
+
+                node->next = list;
+                list = m_wheel->slots[level][slot];
+                m_wheel->slots[level][slot] = nullptr;
+            }
+
+            m_wheel->usedSlots[level] = 0;
+        }
+    }
+
+    return list;
+}
@@ -21,7 +21,8 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <memory>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -55,7 +56,15 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+// Events are kept in a hierarchical timing wheel. Level 0 has one slot per ms of the current
+// EVENT_WHEEL_SLOTS ms, each following level covers EVENT_WHEEL_SLOTS times the range of the previous one.
+// Events further away than the last level are kept in an overflow list.
+#define EVENT_WHEEL_BITS        5
+#define EVENT_WHEEL_SLOTS       (1 << EVENT_WHEEL_BITS)
+#define EVENT_WHEEL_LEVELS      4
+
+// event list nodes are allocated in blocks and reused
+#define EVENT_NODE_BLOCK_SIZE   16
 
 class EventProcessor
 {
@@ -71,8 +80,42 @@ class EventProcessor
 
     protected:
 
+        struct EventNode
+        {
+            BasicEvent* event;
+            uint64 time;
+            EventNode* next;
+        };
+
+        struct EventWheel
+        {
+            EventNode* slots[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];    // newest event first
+            uint32 usedSlots[EVENT_WHEEL_LEVELS];                       // bit set for each non-empty slot
+        };
+
+        EventNode* AllocateNode();
+        void FreeNode(EventNode* node);
+
+        // put event into the ready list, the wheel or the overflow list depending on its time
+        void Schedule(EventNode* node);
+        // time of the next event, UINT64_MAX if there is none
+        uint64 GetNextEventTime() const;
+        // move wheel time forward, there must be no events before time
+        void AdvanceTo(uint64 time);
+        // remove all events from all lists, returned list is unordered
+        EventNode* DetachAll();
+        // lists in the wheel are newest first, reversing them gives insertion order
+        static EventNode* ReverseList(EventNode* list);
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_wheelTime;                                 // events up to this time are in the ready list
+        uint64 m_nextEventTime;                             // no event is due before this time
+        std::unique_ptr<EventWheel> m_wheel;                // allocated when first needed
+        EventNode* m_overflow;
+        EventNode* m_readyHead;                             // due events in execution order
+        EventNode* m_readyTail;
+        EventNode* m_freeNodes;
+        std::vector<std::unique_ptr<EventNode[]>> m_nodeBlocks;
         bool m_aborting;
 };
 
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MPSCQUEUE_H
+#define MANGOS_MPSCQUEUE_H
+
+#include <atomic>
+
+// Link of an element in MPSCQueue, the queued class derives from it
+class MPSCQueueNode
+{
+        template<typename T> friend class MPSCQueue;
+
+    public:
+        MPSCQueueNode() : m_queueNext(nullptr) {}
+        // copies are never linked into the queue of the original
+        MPSCQueueNode(MPSCQueueNode const&) : m_queueNext(nullptr) {}
+        MPSCQueueNode& operator=(MPSCQueueNode const&) { return *this; }
+
+    private:
+        std::atomic<MPSCQueueNode*> m_queueNext;
+};
+
+// Intrusive lock-free multi producer single consumer queue (Vyukov's algorithm)
+// Push can be called from any thread, Peek and Pop only by one thread at a time.
+// Elements are not owned by the queue and must stay alive while linked.
+template<typename T>
+class MPSCQueue
+{
+    public:
+        MPSCQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+        void Push(T* element) { PushNode(element); }
+
+        // Returns the element the next Pop will return without removing it, nullptr when the queue is empty
+        // Pop may still return nullptr afterwards while the producer of the next element is linking it
+        T* Peek() const
+        {
+            MPSCQueueNode* tail = m_tail;
+            if (tail == &m_stub)
+                tail = tail->m_queueNext.load(std::memory_order_acquire);
+
+            return static_cast<T*>(tail);
+        }
+
+        // Returns nullptr when the queue is empty or the only remaining element is still being linked by its producer
+        T* Pop()
+        {
+            MPSCQueueNode* tail = m_tail;
+            MPSCQueueNode* next = tail->m_queueNext.load(std::memory_order_acquire);
+            if (tail == &m_stub)
+            {
+                if (!next)
+                    return nullptr;
+
+                m_tail = next;
+                tail = next;
+                next = next->m_queueNext.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                m_tail = next;
+                return static_cast<T*>(tail);
+            }
+
+            if (tail != m_head.load(std::memory_order_acquire))
+                return nullptr;
+
+            // tail is the last element, put the stub behind it so it can be unlinked
+            PushNode(&m_stub);
+
+            next = tail->m_queueNext.load(std::memory_order_acquire);
+            if (next)
+            {
+                m_tail = next;
+                return static_cast<T*>(tail);
+            }
+
+            return nullptr;
+        }
+
+    private:
+        MPSCQueue(MPSCQueue const&);
+        MPSCQueue& operator=(MPSCQueue const&);
+
+        void PushNode(MPSCQueueNode* node)
+        {
+            node->m_queueNext.store(nullptr, std::memory_order_relaxed);
+            MPSCQueueNode* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->m_queueNext.store(node, std::memory_order_release);
+        }
+
+        std::atomic<MPSCQueueNode*> m_head;                 // last pushed node, written by producers
+        MPSCQueueNode* m_tail;                              // next node to pop, consumer only
+        MPSCQueueNode m_stub;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MPSCRINGBUFFER_H
+#define MANGOS_MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free multi producer single consumer ring buffer (Vyukov's bounded queue)
+// Push can be called from any thread and fails when the buffer is full, Pop only by one thread at a time.
+template<typename T>
+class MPSCRingBuffer
+{
+    public:
+        // capacity is rounded up to a power of two
+        explicit MPSCRingBuffer(size_t capacity) : m_enqueuePos(0), m_dequeuePos(0)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            m_mask = size - 1;
+            m_cells.reset(new Cell[size]);
+            for (size_t i = 0; i < size; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        size_t Capacity() const { return m_mask + 1; }
+
+        bool Push(T&& value)
+        {
+            Cell* cell;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                ptrdiff_t diff = ptrdiff_t(sequence) - ptrdiff_t(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;                           // full, the consumer did not free the cell yet
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Returns false when the buffer is empty or the next element is still being written by its producer
+        bool Pop(T& value)
+        {
+            Cell* cell = &m_cells[m_dequeuePos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            if (ptrdiff_t(sequence) - ptrdiff_t(m_dequeuePos + 1) < 0)
+                return false;
+
+            value = std::move(cell->value);
+            cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+            ++m_dequeuePos;
+            return true;
+        }
+
+    private:
+        MPSCRingBuffer(MPSCRingBuffer const&);
+        MPSCRingBuffer& operator=(MPSCRingBuffer const&);
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_enqueuePos;       // written by producers
+        alignas(64) size_t m_dequeuePos;                    // consumer only
+};
+
+#endif
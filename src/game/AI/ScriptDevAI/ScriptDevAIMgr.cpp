@@ -551,6 +551,23 @@ uint32 ScriptDevAIMgr::GetScriptId(const char* name) const
     return uint32(itr - m_scriptNames.begin());
 }
 
+// Script ids are indexes into the sorted name list, storages holding them must be reloaded when it changes
+uint64 ScriptDevAIMgr::GetScriptNamesHash() const
+{
+    uint64 hash = 0xCBF29CE484222325ULL;                    // FNV-1a
+    for (std::string const& name : m_scriptNames)
+    {
+        for (char c : name)
+        {
+            hash ^= uint8(c);
+            hash *= 0x100000001B3ULL;
+        }
+        hash ^= 0xFF;                                       // separator, no valid name character
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
 void ScriptDevAIMgr::LoadAreaTriggerScripts()
 {
     m_AreaTriggerScripts.clear();                           // need for reload case
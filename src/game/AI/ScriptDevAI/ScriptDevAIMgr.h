@@ -140,6 +140,7 @@ public:
     const char* GetScriptName(uint32 id) const { return id < m_scriptNames.size() ? m_scriptNames[id].c_str() : ""; }
     uint32 GetScriptId(const char* name) const;
     uint32 GetScriptIdsCount() const { return m_scriptNames.size(); }
+    uint64 GetScriptNamesHash() const;
 
     CreatureAI* GetCreatureAI(Creature* creature);
     GameObjectAI* GetGameObjectAI(GameObject* gameobject);
@@ -48,6 +48,12 @@ AuctionHouseMgr::~AuctionHouseMgr()
         delete itr->second;
 }
 
+void AuctionHouseMgr::RebuildSearchNames()
+{
+    for (AuctionHouseObject& auctionHouse : mAuctions)
+        auctionHouse.RebuildSearchNames();
+}
+
 AuctionHouseObject* AuctionHouseMgr::GetAuctionsMap(AuctionHouseEntry const* house)
 {
     if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
@@ -79,6 +85,8 @@ uint32 AuctionHouseMgr::GetAuctionDeposit(AuctionHouseEntry const* entry, uint32
 // does not clear ram
 void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
 {
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
+
     Item* pItem = GetAItem(auction->itemGuidLow);
     if (!pItem)
         return;
@@ -167,6 +175,8 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
 // call this method to send mail to auction owner, when auction is successful, it does not clear ram
 void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
 {
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
+
     ObjectGuid owner_guid = ObjectGuid(HIGHGUID_PLAYER, auction->owner);
     Player* owner = sObjectMgr.GetPlayer(owner_guid);
 
@@ -207,6 +217,8 @@ void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
 // does not clear ram
 void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
 {
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
+
     // return an item in auction to its owner by mail
     Item* pItem = GetAItem(auction->itemGuidLow);
     if (!pItem)
@@ -544,6 +556,7 @@ void AuctionHouseObject::Update()
 
             itr->second->DeleteFromDB();
             sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
+            RemoveFromSearchIndex(itr->second);
             delete itr->second;
             AuctionsMap.erase(itr++);
         }
@@ -578,68 +591,273 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
-void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
-        std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
-        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
-        uint32& count, uint32& totalcount)
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
 {
-    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+    MANGOS_ASSERT(ah);
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    AuctionEntryMap::iterator itr = AuctionsMap.find(ah->Id);
+    if (itr != AuctionsMap.end())
+        RemoveFromSearchIndex(itr->second);
+
+    AuctionsMap[ah->Id] = ah;
+    AddToSearchIndex(ah);
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    RemoveFromSearchIndex(itr->second);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+static void BuildSearchNames(ItemPrototype const* proto, std::vector<std::wstring>& names)
+{
+    ItemLocale const* itemLocale = sObjectMgr.GetItemLocale(proto->ItemId);
+    names.assign(1 + (itemLocale ? itemLocale->Name.size() : 0), std::wstring());
+
+    for (size_t i = 0; i < names.size(); ++i)
     {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
-            continue;
+        std::string name = proto->Name1;
+        sObjectMgr.GetItemLocaleStrings(proto->ItemId, int32(i) - 1, &name);
 
-        {
-            ItemPrototype const* proto = item->GetProto();
+        // names not convertible can't match any search, as in Utf8FitTo
+        if (Utf8toWStr(name, names[i]))
+            wstrToLower(names[i]);
+        else
+            names[i].clear();
+    }
+}
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+void AuctionHouseObject::AddToSearchIndex(AuctionEntry* ah)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(ah->itemTemplate);
+    if (!proto)
+        return;
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+    m_classIndex[proto->Class][ah->Id] = ah;
+    m_subClassIndex[(proto->Class << 16) | proto->SubClass][ah->Id] = ah;
+    m_inventoryTypeIndex[proto->InventoryType][ah->Id] = ah;
+    m_qualityIndex[proto->Quality][ah->Id] = ah;
+    m_requiredLevelIndex[proto->RequiredLevel][ah->Id] = ah;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+    SearchName& searchName = m_searchNames[ah->itemTemplate];
+    if (!searchName.auctions++)
+        BuildSearchNames(proto, searchName.names);
+}
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+void AuctionHouseObject::RemoveFromSearchIndex(AuctionEntry const* ah)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(ah->itemTemplate);
+    if (!proto)
+        return;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+    m_classIndex[proto->Class].erase(ah->Id);
+    m_subClassIndex[(proto->Class << 16) | proto->SubClass].erase(ah->Id);
+    m_inventoryTypeIndex[proto->InventoryType].erase(ah->Id);
+    m_qualityIndex[proto->Quality].erase(ah->Id);
+    m_requiredLevelIndex[proto->RequiredLevel].erase(ah->Id);
 
-            if (usable != 0x00)
-            {
-                if (player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
+    SearchNameMap::iterator itr = m_searchNames.find(ah->itemTemplate);
+    if (itr != m_searchNames.end() && !--itr->second.auctions)
+        m_searchNames.erase(itr);
+}
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
-                {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
-                    {
-                        if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
-                    }
-                }
+std::wstring const& AuctionHouseObject::GetSearchName(uint32 itemTemplate, int loc_idx) const
+{
+    static std::wstring const noName;
+
+    SearchNameMap::const_iterator itr = m_searchNames.find(itemTemplate);
+    if (itr == m_searchNames.end())
+        return noName;
+
+    // locales without a name of the item use the default name
+    std::vector<std::wstring> const& names = itr->second.names;
+    uint32 index = loc_idx >= 0 ? uint32(loc_idx) + 1 : 0;
+    return index < names.size() ? names[index] : names[0];
+}
+
+void AuctionHouseObject::RebuildSearchNames()
+{
+    for (SearchNameMap::iterator itr = m_searchNames.begin(); itr != m_searchNames.end(); ++itr)
+        if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itr->first))
+            BuildSearchNames(proto, itr->second.names);
+}
+
+struct AuctionListFilter
+{
+    AuctionHouseObject const* auctionHouse;
+    Player* player;
+    int loc_idx;
+    std::wstring const* searchedname;
+    uint32 listfrom;
+    uint32 levelmin;
+    uint32 levelmax;
+    uint32 usable;
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;
+};
+
+static void ListAuctionIfMatch(WorldPacket& data, AuctionEntry* Aentry, AuctionListFilter const& filter, uint32& count, uint32& totalcount)
+{
+    Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+    if (!item)
+        return;
+
+    ItemPrototype const* proto = item->GetProto();
+
+    if (filter.itemClass != 0xffffffff && proto->Class != filter.itemClass)
+        return;
+
+    if (filter.itemSubClass != 0xffffffff && proto->SubClass != filter.itemSubClass)
+        return;
+
+    if (filter.inventoryType != 0xffffffff && proto->InventoryType != filter.inventoryType)
+        return;
+
+    if (filter.quality != 0xffffffff && proto->Quality < filter.quality)
+        return;
+
+    if (filter.levelmin != 0x00 && (proto->RequiredLevel < filter.levelmin || (filter.levelmax != 0x00 && proto->RequiredLevel > filter.levelmax)))
+        return;
+
+    if (filter.usable != 0x00)
+    {
+        if (filter.player->CanUseItem(item) != EQUIP_ERR_OK)
+            return;
+
+        if (proto->Class == ITEM_CLASS_RECIPE)
+        {
+            if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+            {
+                if (filter.player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                    return;
             }
+        }
+    }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+    if (!filter.searchedname->empty() && filter.auctionHouse->GetSearchName(proto->ItemId, filter.loc_idx).find(*filter.searchedname) == std::wstring::npos)
+        return;
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+    if (count < 50 && totalcount >= filter.listfrom)
+    {
+        ++count;
+        Aentry->BuildAuctionInfo(data);
+    }
+
+    ++totalcount;
+}
+
+void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
+        std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
+        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
+        uint32& count, uint32& totalcount)
+{
+    static AuctionEntryMap const noAuctions;
+
+    AuctionListFilter filter;
+    filter.auctionHouse = this;
+    filter.player = player;
+    filter.loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+    filter.searchedname = &wsearchedname;
+    filter.listfrom = listfrom;
+    filter.levelmin = levelmin;
+    filter.levelmax = levelmax;
+    filter.usable = usable;
+    filter.inventoryType = inventoryType;
+    filter.itemClass = itemClass;
+    filter.itemSubClass = itemSubClass;
+    filter.quality = quality;
+
+    // start from the smallest index bucket of the exact filters, all filters are still checked per auction
+    AuctionEntryMap const* candidates = &AuctionsMap;
+
+    if (itemClass != 0xffffffff)
+    {
+        AuctionIndex::const_iterator itr = itemSubClass != 0xffffffff ?
+                                           m_subClassIndex.find((itemClass << 16) | itemSubClass) : m_classIndex.find(itemClass);
+        AuctionIndex::const_iterator end = itemSubClass != 0xffffffff ? m_subClassIndex.end() : m_classIndex.end();
+        candidates = itr != end ? &itr->second : &noAuctions;
+    }
 
-            if (count < 50 && totalcount >= listfrom)
+    if (inventoryType != 0xffffffff)
+    {
+        AuctionIndex::const_iterator itr = m_inventoryTypeIndex.find(inventoryType);
+        AuctionEntryMap const* byInventoryType = itr != m_inventoryTypeIndex.end() ? &itr->second : &noAuctions;
+        if (byInventoryType->size() < candidates->size())
+            candidates = byInventoryType;
+    }
+
+    // range filters span several buckets, use them only when their union is smaller
+    std::vector<AuctionEntryMap const*> rangeBuckets;
+    size_t rangeSize = candidates->size();
+
+    if (quality != 0xffffffff && quality != 0)
+    {
+        std::vector<AuctionEntryMap const*> buckets;
+        size_t size = 0;
+        for (AuctionIndex::const_iterator itr = m_qualityIndex.begin(); itr != m_qualityIndex.end(); ++itr)
+        {
+            if (itr->first >= quality && !itr->second.empty())
             {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                buckets.push_back(&itr->second);
+                size += itr->second.size();
+            }
+        }
+
+        if (size < rangeSize)
+        {
+            rangeBuckets.swap(buckets);
+            rangeSize = size;
+        }
+    }
+
+    if (levelmin != 0x00)
+    {
+        std::vector<AuctionEntryMap const*> buckets;
+        size_t size = 0;
+        for (AuctionIndex::const_iterator itr = m_requiredLevelIndex.begin(); itr != m_requiredLevelIndex.end(); ++itr)
+        {
+            if (itr->first >= levelmin && (levelmax == 0x00 || itr->first <= levelmax) && !itr->second.empty())
+            {
+                buckets.push_back(&itr->second);
+                size += itr->second.size();
             }
         }
 
-        ++totalcount;
+        if (size < rangeSize)
+        {
+            rangeBuckets.swap(buckets);
+            rangeSize = size;
+        }
     }
+
+    if (rangeSize < candidates->size())
+    {
+        // merge the buckets back into auction id order, the client pages by position
+        std::vector<AuctionEntry*> auctions;
+        auctions.reserve(rangeSize);
+        for (std::vector<AuctionEntryMap const*>::const_iterator bucket = rangeBuckets.begin(); bucket != rangeBuckets.end(); ++bucket)
+            for (AuctionEntryMap::const_iterator itr = (*bucket)->begin(); itr != (*bucket)->end(); ++itr)
+                auctions.push_back(itr->second);
+
+        std::sort(auctions.begin(), auctions.end(), [](AuctionEntry const* left, AuctionEntry const* right)
+        {
+            return left->Id < right->Id;
+        });
+
+        for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+            ListAuctionIfMatch(data, *itr, filter, count, totalcount);
+        return;
+    }
+
+    for (AuctionEntryMap::const_iterator itr = candidates->begin(); itr != candidates->end(); ++itr)
+        ListAuctionIfMatch(data, itr->second, filter, count, totalcount);
 }
 
 AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout, uint32 deposit, Player* pl /*= nullptr*/)
@@ -668,6 +886,8 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->MoveItemFromInventory(newItem->GetBagSlot(), newItem->GetSlot(), true);
 
+    // the auction is also changed by bidders and expiry
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
     CharacterDatabase.BeginTransaction();
 
     if (pl)
@@ -734,12 +954,14 @@ uint32 AuctionEntry::GetAuctionOutBid() const
 
 void AuctionEntry::DeleteFromDB() const
 {
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
     // No SQL injection (Id is integer)
     CharacterDatabase.PExecute("DELETE FROM auction WHERE id = '%u'", Id);
 }
 
 void AuctionEntry::SaveToDB() const
 {
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
     // No SQL injection (no strings)
     CharacterDatabase.PExecute("INSERT INTO auction (id,houseid,itemguid,item_template,item_count,item_randompropertyid,itemowner,buyoutprice,time,buyguid,lastbid,startbid,deposit) "
                                "VALUES ('%u', '%u', '%u', '%u', '%u', '%i', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u')",
@@ -754,6 +976,7 @@ void AuctionEntry::AuctionBidWinning(Player* newbidder)
     sAuctionMgr.RemoveAItem(this->itemGuidLow);
     sAuctionMgr.GetAuctionsMap(this->auctionHouseEntry)->RemoveAuction(this->Id);
 
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
     CharacterDatabase.BeginTransaction();
     this->DeleteFromDB();
     if (newbidder)
@@ -793,6 +1016,7 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=nullptr*/)
             auction_owner->GetSession()->SendAuctionOwnerNotification(this, false);
 
         // after this update we should save player's money ...
+        Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
         CharacterDatabase.BeginTransaction();
         CharacterDatabase.PExecute("UPDATE auction SET buyguid = '%u', lastbid = '%u' WHERE id = '%u'", bidder, bid, Id);
         if (newbidder)
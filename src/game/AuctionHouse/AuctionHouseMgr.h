@@ -23,6 +23,7 @@
 #include "Server/DBCStructure.h"
 
 class Item;
+struct ItemPrototype;
 class Player;
 class Unit;
 class WorldPacket;
@@ -96,11 +97,7 @@ class AuctionHouseObject
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -108,7 +105,7 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id) { return !!AuctionsMap.erase(id); }
+        bool RemoveAuction(uint32 id);
 
         void Update();
 
@@ -119,8 +116,34 @@ class AuctionHouseObject
                                    uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
                                    uint32& count, uint32& totalcount);
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
+
+        // lower case item name for auction name search, built when the first auction of the item is added
+        std::wstring const& GetSearchName(uint32 itemTemplate, int loc_idx) const;
+        void RebuildSearchNames();
     private:
+        typedef std::unordered_map<uint32, AuctionEntryMap> AuctionIndex;
+
+        struct SearchName
+        {
+            SearchName() : auctions(0) {}
+
+            std::vector<std::wstring> names;                // by loc_idx + 1
+            uint32 auctions;                                // auctions of the item in the house
+        };
+        typedef std::unordered_map<uint32, SearchName> SearchNameMap;
+
+        void AddToSearchIndex(AuctionEntry* ah);
+        void RemoveFromSearchIndex(AuctionEntry const* ah);
+
         AuctionEntryMap AuctionsMap;
+
+        // Search indexes by item template fields, each keeps the auctions in AuctionsMap order
+        AuctionIndex m_classIndex;                          // by item class
+        AuctionIndex m_subClassIndex;                       // by item class << 16 | subclass
+        AuctionIndex m_inventoryTypeIndex;                  // by inventory type
+        AuctionIndex m_qualityIndex;                        // by quality
+        AuctionIndex m_requiredLevelIndex;                  // by required level
+        SearchNameMap m_searchNames;                        // by item template
 };
 
 enum AuctionHouseType
@@ -162,6 +185,8 @@ class AuctionHouseMgr
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
+        void RebuildSearchNames();
+
     public:
         // load first auction items, because of check if item exists, when loading
         void LoadAuctionItems();
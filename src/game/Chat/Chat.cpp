@@ -654,6 +654,14 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                        "", nullptr }
     };
 
+    static ChatCommand serverTickStatsCommandTable[] =
+    {
+        { "dump",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerTickStatsDumpCommand, "", nullptr },
+        { "reset",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerTickStatsResetCommand, "", nullptr },
+        { "",               SEC_GAMEMASTER,     true,  &ChatHandler::HandleServerTickStatsCommand,     "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                        "", nullptr }
+    };
+
     static ChatCommand serverCommandTable[] =
     {
         { "corpses",        SEC_GAMEMASTER,     true,  &ChatHandler::HandleServerCorpsesCommand,       "", nullptr },
@@ -668,6 +676,7 @@ ChatCommand* ChatHandler::getCommandTable()
         { "restart",        SEC_ADMINISTRATOR,  true,  nullptr,                                        "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  nullptr,                                        "", serverShutdownCommandTable },
         { "set",            SEC_ADMINISTRATOR,  true,  nullptr,                                        "", serverSetCommandTable },
+        { "tickstats",      SEC_GAMEMASTER,     true,  nullptr,                                        "", serverTickStatsCommandTable },
         { nullptr,          0,                  false, nullptr,                                        "", nullptr }
     };
 
@@ -501,6 +501,9 @@ class ChatHandler
         bool HandleServerSetMotdCommand(char* args);
         bool HandleServerShutDownCommand(char* args);
         bool HandleServerShutDownCancelCommand(char* args);
+        bool HandleServerTickStatsCommand(char* args);
+        bool HandleServerTickStatsDumpCommand(char* args);
+        bool HandleServerTickStatsResetCommand(char* args);
 
         bool HandleTeleCommand(char* args);
         bool HandleTeleAddCommand(char* args);
@@ -54,6 +54,7 @@
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "Server/SQLStorages.h"
 #include "Loot/LootMgr.h"
+#include "World/WorldTickProfiler.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -1032,6 +1033,7 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sAuctionMgr.RebuildSearchNames();
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -5775,6 +5777,57 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerTickStatsCommand(char* args)
+{
+    uint32 maxMaps;
+    if (!ExtractOptUInt32(&args, maxMaps, 10))
+        return false;
+
+    std::vector<std::string> lines;
+    sTickProfiler.BuildReport(lines, maxMaps);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        SendSysMessage(itr->c_str());
+
+    return true;
+}
+
+bool ChatHandler::HandleServerTickStatsResetCommand(char* /*args*/)
+{
+    sTickProfiler.Reset();
+    SendSysMessage("Tick statistics reset.");
+    return true;
+}
+
+bool ChatHandler::HandleServerTickStatsDumpCommand(char* args)
+{
+    std::string filename;
+    if (char* name = ExtractLiteralArg(&args))
+    {
+        filename = name;
+
+        // plain file name only, dump always goes to LogsDir
+        if (filename[0] == '.' || filename.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.") != std::string::npos)
+        {
+            PSendSysMessage("Invalid file name %s.", filename.c_str());
+            SetSentErrorMessage(true);
+            return false;
+        }
+    }
+    else
+        filename = "tickstats_" + Log::GetTimestampStr() + ".log";
+
+    if (!sTickProfiler.DumpToFile(filename))
+    {
+        PSendSysMessage("Can't write tick statistics to %s.", filename.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Tick statistics written to %s.", filename.c_str());
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
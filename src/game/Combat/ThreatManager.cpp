@@ -64,6 +64,7 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager* pThreatManager, f
     iUnitGuid = pUnit->GetObjectGuid();
     iOnline = true;
     iAccessible = true;
+    iContainer = nullptr;
 }
 
 //============================================================
@@ -105,6 +106,9 @@ void HostileReference::addThreat(float pMod)
         pMod = -iThreat;
 
     iThreat += pMod;
+    if (iContainer && pMod != 0.0f)
+        iContainer->reorder(this);
+
     // the threat is changed. Source and target unit have to be availabe
     // if the link was cut before relink it again
     if (!isOnline())
@@ -218,6 +222,65 @@ void ThreatContainer::clearReferences()
         delete(*i);
     }
     iThreatList.clear();
+    iReferencesByGuid.clear();
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    // a reference is only held by one container at a time
+    if (pHostileReference->iContainer)
+        pHostileReference->iContainer->remove(pHostileReference);
+
+    // new references usually have the lowest threat, search their position from the back
+    ThreatList::iterator pos = iThreatList.end();
+    while (pos != iThreatList.begin() && (*std::prev(pos))->getThreat() < pHostileReference->getThreat())
+        --pos;
+
+    pHostileReference->iContainer = this;
+    pHostileReference->iContainerPos = iThreatList.insert(pos, pHostileReference);
+    iReferencesByGuid[pHostileReference->getUnitGuid()] = pHostileReference;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    if (pRef->iContainer != this)
+        return;
+
+    iThreatList.erase(pRef->iContainerPos);
+    iReferencesByGuid.erase(pRef->getUnitGuid());
+    pRef->iContainer = nullptr;
+}
+
+//============================================================
+// Splice the reference behind the last one with at least its threat,
+// references with equal threat keep their order and iterators stay valid
+
+void ThreatContainer::reorder(HostileReference* pRef)
+{
+    ThreatList::iterator pos = pRef->iContainerPos;
+    float threat = pRef->getThreat();
+
+    // threat raised, move towards the front
+    ThreatList::iterator dest = pos;
+    while (dest != iThreatList.begin() && (*std::prev(dest))->getThreat() < threat)
+        --dest;
+
+    if (dest == pos)
+    {
+        // threat lowered, move towards the back
+        dest = std::next(pos);
+        while (dest != iThreatList.end() && (*dest)->getThreat() >= threat)
+            ++dest;
+
+        if (dest == std::next(pos))
+            return;
+    }
+
+    iThreatList.splice(dest, iThreatList, pos);
 }
 
 //============================================================
@@ -226,18 +289,9 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
 {
     if (!pVictim)
         return nullptr;
-    HostileReference* result = nullptr;
-    ObjectGuid guid = pVictim->GetObjectGuid();
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        if ((*i)->getUnitGuid() == guid)
-        {
-            result = (*i);
-            break;
-        }
-    }
 
-    return result;
+    std::unordered_map<ObjectGuid, HostileReference*>::const_iterator itr = iReferencesByGuid.find(pVictim->GetObjectGuid());
+    return itr != iReferencesByGuid.end() ? itr->second : nullptr;
 }
 
 //============================================================
@@ -267,26 +321,6 @@ void ThreatContainer::modifyThreatPercent(Unit* pVictim, int32 pPercent)
     }
 }
 
-//============================================================
-
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x))==false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
-//============================================================
-// Check if the list is dirty and sort if necessary
-
-void ThreatContainer::update()
-{
-    if (iDirty && iThreatList.size() > 1)
-    {
-        iThreatList.sort(HostileReferenceSortPredicate);
-    }
-    iDirty = false;
-}
-
 //============================================================
 // return the next best victim
 // could be the current victim
@@ -461,7 +495,6 @@ void ThreatManager::modifyThreatPercent(Unit* pVictim, int32 pPercent)
 
 Unit* ThreatManager::getHostileTarget()
 {
-    iThreatContainer.update();
     HostileReference* nextVictim = iThreatContainer.selectNextVictim((Creature*) getOwner(), getCurrentVictim());
     setCurrentVictim(nextVictim);
     return getCurrentVictim() != nullptr ? getCurrentVictim()->getTarget() : nullptr;
@@ -537,35 +570,24 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileReference && threatRefStatusChangeEvent->getFValue() < 0.0f) ||
-                    (getCurrentVictim() != hostileReference && threatRefStatusChangeEvent->getFValue() > 0.0f))
-                setDirty(true);                             // the order in the threat list might have changed
-            break;
+            break;                                          // the containers reorder the reference themselves
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostileReference->isOnline())
             {
                 if (hostileReference == getCurrentVictim())
-                {
                     setCurrentVictim(nullptr);
-                    setDirty(true);
-                }
                 iThreatContainer.remove(hostileReference);
                 iThreatOfflineContainer.addReference(hostileReference);
             }
             else
             {
-                if (getCurrentVictim() && hostileReference->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                    setDirty(true);
-                iThreatContainer.addReference(hostileReference);
                 iThreatOfflineContainer.remove(hostileReference);
+                iThreatContainer.addReference(hostileReference);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
             if (hostileReference == getCurrentVictim())
-            {
                 setCurrentVictim(nullptr);
-                setDirty(true);
-            }
             if (hostileReference->isOnline())
             {
                 iThreatContainer.remove(hostileReference);
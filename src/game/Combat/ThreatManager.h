@@ -25,14 +25,19 @@
 #include "Entities/UnitEvents.h"
 #include "Entities/ObjectGuid.h"
 #include <list>
+#include <unordered_map>
 
 //==============================================================
 
 class Unit;
 class Creature;
 class ThreatManager;
+class ThreatContainer;
+class HostileReference;
 struct SpellEntry;
 
+typedef std::list<HostileReference*> ThreatList;
+
 //==============================================================
 // Class to calculate the real threat based
 
@@ -116,6 +121,8 @@ class HostileReference : public Reference<Unit, ThreatManager>
         // Tell our refFrom (source) object, that the link is cut (Target destroyed)
         void sourceObjectDestroyLink() override;
     private:
+        friend class ThreatContainer;
+
         // Inform the source, that the status of that reference was changed
         void fireStatusChanged(ThreatRefStatusChangeEvent& pThreatRefStatusChangeEvent);
 
@@ -126,28 +133,29 @@ class HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool iOnline;
         bool iAccessible;
+        ThreatContainer* iContainer;                        // container holding the reference, nullptr if none
+        ThreatList::iterator iContainerPos;                 // position in iContainer, valid only with iContainer set
 };
 
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
-
 class ThreatContainer
 {
     private:
-        ThreatList iThreatList;
-        bool iDirty;
+        ThreatList iThreatList;                             // highest threat first, kept ordered on every threat change
+        std::unordered_map<ObjectGuid, HostileReference*> iReferencesByGuid;
     protected:
         friend class ThreatManager;
+        friend class HostileReference;
 
-        void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void remove(HostileReference* pRef);
+        void addReference(HostileReference* pHostileReference);
         void clearReferences();
-        // Sort the list if necessary
-        void update();
+        // Move the reference to the position of its changed threat
+        void reorder(HostileReference* pRef);
     public:
-        ThreatContainer() { iDirty = false; }
+        ThreatContainer() {}
         ~ThreatContainer() { clearReferences(); }
 
         HostileReference* addThreat(Unit* pVictim, float pThreat);
@@ -156,10 +164,6 @@ class ThreatContainer
 
         HostileReference* selectNextVictim(Creature* pAttacker, HostileReference* pCurrentVictim);
 
-        void setDirty(bool pDirty) { iDirty = pDirty; }
-
-        bool isDirty() const { return iDirty; }
-
         bool empty() const { return iThreatList.empty(); }
 
         HostileReference* getMostHated() { return iThreatList.empty() ? nullptr : iThreatList.front(); }
@@ -208,8 +212,6 @@ class ThreatManager
         void setCurrentVictim(HostileReference* pHostileReference);
         void setCurrentVictimByTarget(Unit* target); // Used in SPELL_EFFECT_ATTACK_ME to set the current target to the taunter
 
-        void setDirty(bool pDirty) { iThreatContainer.setDirty(pDirty); }
-
         // Don't must be used for explicit modify threat values in iterator return pointers
         ThreatList const& getThreatList() const { return iThreatContainer.getThreatList(); }
     private:
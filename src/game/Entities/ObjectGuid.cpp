@@ -63,12 +63,13 @@ std::string ObjectGuid::GetString() const
 template<HighGuid high>
 uint32 ObjectGuidGenerator<high>::Generate()
 {
-    if (m_nextGuid >= ObjectGuid::GetMaxCounter(high) - 1)
+    uint32 guid = m_nextGuid++;
+    if (guid >= ObjectGuid::GetMaxCounter(high) - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
@@ -95,6 +96,88 @@ ByteBuffer& operator>>(ByteBuffer& buf, PackedGuidReader const& guid)
     return buf;
 }
 
+#define GUID_FLAT_SET_MIN_CAPACITY  32
+
+size_t GuidFlatSet::GetHomeSlot(ObjectGuid const& guid) const
+{
+    // fibonacci hashing, counters in the low bits spread over the whole table
+    return size_t((guid.GetRawValue() * uint64(0x9E3779B97F4A7C15)) >> 32) & (m_slots.size() - 1);
+}
+
+size_t GuidFlatSet::FindSlot(ObjectGuid const& guid) const
+{
+    size_t const mask = m_slots.size() - 1;
+    size_t slot = GetHomeSlot(guid);
+    while (!m_slots[slot].IsEmpty() && m_slots[slot] != guid)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+GuidFlatSet::const_iterator GuidFlatSet::find(ObjectGuid const& guid) const
+{
+    if (m_slots.empty())
+        return end();
+
+    size_t slot = FindSlot(guid);
+    if (m_slots[slot] != guid)
+        return end();
+
+    return const_iterator(m_slots.data() + slot, m_slots.data() + m_slots.size());
+}
+
+bool GuidFlatSet::insert(ObjectGuid const& guid)
+{
+    MANGOS_ASSERT(!guid.IsEmpty());
+
+    // keep the load factor at most 3/4
+    if ((m_size + 1) * 4 > m_slots.size() * 3)
+        Rehash(m_slots.empty() ? GUID_FLAT_SET_MIN_CAPACITY : m_slots.size() * 2);
+
+    size_t slot = FindSlot(guid);
+    if (m_slots[slot] == guid)
+        return false;
+
+    m_slots[slot] = guid;
+    ++m_size;
+    return true;
+}
+
+size_t GuidFlatSet::erase(ObjectGuid const& guid)
+{
+    if (m_slots.empty())
+        return 0;
+
+    size_t const mask = m_slots.size() - 1;
+    size_t hole = FindSlot(guid);
+    if (m_slots[hole] != guid)
+        return 0;
+
+    // move back following entries of the probe sequence which may not stay behind the hole
+    for (size_t slot = (hole + 1) & mask; !m_slots[slot].IsEmpty(); slot = (slot + 1) & mask)
+    {
+        size_t home = GetHomeSlot(m_slots[slot]);
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            m_slots[hole] = m_slots[slot];
+            hole = slot;
+        }
+    }
+
+    m_slots[hole] = ObjectGuid();
+    --m_size;
+    return 1;
+}
+
+void GuidFlatSet::Rehash(size_t capacity)
+{
+    std::vector<ObjectGuid> old(capacity);
+    old.swap(m_slots);
+
+    for (std::vector<ObjectGuid>::const_iterator itr = old.begin(); itr != old.end(); ++itr)
+        if (!itr->IsEmpty())
+            m_slots[FindSlot(*itr)] = *itr;
+}
+
 template uint32 ObjectGuidGenerator<HIGHGUID_ITEM>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_PLAYER>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GAMEOBJECT>::Generate();
@@ -22,6 +22,8 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 
+#include <atomic>
+
 enum TypeID
 {
     TYPEID_OBJECT        = 0,
@@ -231,7 +233,69 @@ class ObjectGuidGenerator
         uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
 
     private:                                                // fields
-        uint32 m_nextGuid;
+        std::atomic<uint32> m_nextGuid;                     // maps update in parallel and share the global generators
+};
+
+/**
+ * Open addressing hash set of guids for sets with many lookups and changes, like the objects known by a client.
+ * Linear probing in one array without tombstones, erase shifts the following entries back.
+ * Iteration order is unspecified and iterators are invalidated by insert and erase.
+ */
+class GuidFlatSet
+{
+    public:                                                 // types
+        class const_iterator
+        {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef ObjectGuid value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef ObjectGuid const* pointer;
+                typedef ObjectGuid const& reference;
+
+                const_iterator(ObjectGuid const* slot, ObjectGuid const* end) : m_slot(slot), m_end(end) { SkipEmpty(); }
+
+                ObjectGuid const& operator*() const { return *m_slot; }
+                ObjectGuid const* operator->() const { return m_slot; }
+                const_iterator& operator++() { ++m_slot; SkipEmpty(); return *this; }
+                bool operator==(const_iterator const& other) const { return m_slot == other.m_slot; }
+                bool operator!=(const_iterator const& other) const { return m_slot != other.m_slot; }
+
+            private:
+                void SkipEmpty() { while (m_slot != m_end && m_slot->IsEmpty()) ++m_slot; }
+
+                ObjectGuid const* m_slot;
+                ObjectGuid const* m_end;
+        };
+        typedef const_iterator iterator;
+
+    public:                                                 // constructors
+        GuidFlatSet() : m_size(0) {}
+
+    public:                                                 // modifiers
+        bool insert(ObjectGuid const& guid);
+        size_t erase(ObjectGuid const& guid);
+        void clear() { std::fill(m_slots.begin(), m_slots.end(), ObjectGuid()); m_size = 0; }
+
+    public:                                                 // accessors
+        bool contains(ObjectGuid const& guid) const { return !m_slots.empty() && m_slots[FindSlot(guid)] == guid; }
+        size_t count(ObjectGuid const& guid) const { return contains(guid) ? 1 : 0; }
+        const_iterator find(ObjectGuid const& guid) const;
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const_iterator begin() const { return const_iterator(m_slots.data(), m_slots.data() + m_slots.size()); }
+        const_iterator end() const { return const_iterator(m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()); }
+
+    private:
+        size_t GetHomeSlot(ObjectGuid const& guid) const;
+        // slot of the guid, or the empty slot where it would be inserted
+        size_t FindSlot(ObjectGuid const& guid) const;
+        void Rehash(size_t capacity);
+
+    private:                                                // fields
+        std::vector<ObjectGuid> m_slots;                    // empty guids mark free slots, size is a power of 2
+        size_t m_size;
 };
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
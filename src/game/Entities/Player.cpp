@@ -3427,13 +3427,12 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 
 void Player::_SaveSpellCooldowns()
 {
+    static SqlStatementID deleteSpellCooldowns;
     static SqlStatementID deleteSpellCooldown;
-
-    // delete all old cooldown
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE LowGuid = ?");
-    stmt.PExecute(GetGUIDLow());
-
     static SqlStatementID insertSpellCooldown;
+    static SqlStatementID updateSpellCooldown;
+
+    PlayerSaveState::CooldownMap cooldowns;
     TimePoint currTime = GetMap()->GetCurrentClockTime();
 
     for (auto& cdItr : m_cooldownMap)
@@ -3445,19 +3444,59 @@ void Player::_SaveSpellCooldowns()
             TimePoint cTime = currTime;
             cdData->GetSpellCDExpireTime(sTime);
             cdData->GetCatCDExpireTime(cTime);
-            uint64 spellExpireTime = uint64(Clock::to_time_t(sTime));
-            uint64 catExpireTime = uint64(Clock::to_time_t(cTime));
-
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (LowGuid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt32(cdData->GetSpellId());
-            stmt.addUInt64(spellExpireTime);
-            stmt.addUInt32(cdData->GetCategory());
-            stmt.addUInt64(catExpireTime);
-            stmt.addUInt32(cdData->GetItemId());
-            stmt.Execute();
+
+            PlayerSavedCooldown& cooldown = cooldowns[cdData->GetSpellId()];
+            cooldown.spellExpireTime = uint64(Clock::to_time_t(sTime));
+            cooldown.catExpireTime = uint64(Clock::to_time_t(cTime));
+            cooldown.category = cdData->GetCategory();
+            cooldown.itemId = cdData->GetItemId();
         }
     }
+
+    m_saveState.rewriteStatements += 1 + cooldowns.size();
+
+    // first save rewrites all rows, later saves only changed ones
+    if (!m_saveState.cooldownsSaved)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldowns, "DELETE FROM character_spell_cooldown WHERE LowGuid = ?");
+        stmt.PExecute(GetGUIDLow());
+        ++m_saveState.statements;
+
+        m_saveState.cooldowns.clear();
+        m_saveState.cooldownsSaved = true;
+    }
+
+    for (auto& cdItr : cooldowns)
+    {
+        PlayerSavedCooldown const& cooldown = cdItr.second;
+        auto saved = m_saveState.cooldowns.find(cdItr.first);
+        if (saved != m_saveState.cooldowns.end() && saved->second == cooldown)
+            continue;
+
+        SqlStatement stmt = saved == m_saveState.cooldowns.end() ?
+            CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (SpellExpireTime, Category, CategoryExpireTime, ItemId, LowGuid, SpellId) VALUES( ?, ?, ?, ?, ?, ?)") :
+            CharacterDatabase.CreateStatement(updateSpellCooldown, "UPDATE character_spell_cooldown SET SpellExpireTime = ?, Category = ?, CategoryExpireTime = ?, ItemId = ? WHERE LowGuid = ? AND SpellId = ?");
+        stmt.addUInt64(cooldown.spellExpireTime);
+        stmt.addUInt32(cooldown.category);
+        stmt.addUInt64(cooldown.catExpireTime);
+        stmt.addUInt32(cooldown.itemId);
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt32(cdItr.first);
+        stmt.Execute();
+        ++m_saveState.statements;
+    }
+
+    for (auto& cdItr : m_saveState.cooldowns)
+    {
+        if (cooldowns.find(cdItr.first) != cooldowns.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE LowGuid = ? AND SpellId = ?");
+        stmt.PExecute(GetGUIDLow(), cdItr.first);
+        ++m_saveState.statements;
+    }
+
+    m_saveState.cooldowns.swap(cooldowns);
 }
 
 
@@ -3574,9 +3613,9 @@ void Player::_SetCreateBits(UpdateMask* updateMask, Player* target) const
     }
     else
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint16 index = updateVisualBits.FindNextSetBit(0); index < m_valuesCount; index = updateVisualBits.FindNextSetBit(index + 1))
         {
-            if (GetUInt32Value(index) != 0 && updateVisualBits.GetBit(index))
+            if (GetUInt32Value(index) != 0)
                 updateMask->SetBit(index);
         }
     }
@@ -13256,7 +13295,7 @@ void Player::SendQuestGiverStatusMultiple() const
     WorldPacket data(SMSG_QUESTGIVER_STATUS_MULTIPLE, 4);
     data << uint32(count);                                  // placeholder
 
-    for (GuidSet::const_iterator itr = m_clientGUIDs.begin(); itr != m_clientGUIDs.end(); ++itr)
+    for (GuidFlatSet::const_iterator itr = m_clientGUIDs.begin(); itr != m_clientGUIDs.end(); ++itr)
     {
         if (itr->IsAnyTypeCreature())
         {
@@ -13416,6 +13455,8 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
     // overwrite possible wrong/corrupted guid
     SetGuidValue(OBJECT_FIELD_GUID, guid);
 
+    m_saveState.characterRow = true;
+
     // overwrite some data fields
     SetByteValue(UNIT_FIELD_BYTES_0, 0, fields[3].GetUInt8()); // race
     SetByteValue(UNIT_FIELD_BYTES_0, 1, fields[4].GetUInt8()); // class
@@ -14837,129 +14878,206 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
+    // save in order with the other requests of the account, also if called from a map update thread
+    Database::AsyncShardGuard shardGuard(CharacterDatabase, GetSession()->GetAccountId());
+
+    // the values of the last save are only known to be in the database if its transactions committed
+    if (m_saveState.failed->exchange(false))
+        m_saveState.Invalidate();
+
     CharacterDatabase.BeginTransaction();
 
     UpdateHonor();
 
     static SqlStatementID delChar ;
     static SqlStatementID insChar ;
+    static SqlStatementID updChar ;
+
+    m_saveState.statements = 0;
+    m_saveState.rewriteStatements = 2;
+
+    if (m_saveState.characterRow)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, "
+                            "playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+                            "map = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, "
+                            "taximask = ?, online = ?, cinematic = ?, "
+                            "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, "
+                            "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, "
+                            "death_expire_time = ?, taxi_path = ?, "
+                            "honor_highest_rank = ?, honor_standing = ?, stored_honor_rating = ?, stored_dishonorable_kills = ?, stored_honorable_kills = ?, "
+                            "watchedFaction = ?, drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, "
+                            "power4 = ?, power5 = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, actionBars = ? "
+                            "WHERE guid = ?");
+
+        _AddCharacterFields(stmt);
+        stmt.addUInt32(GetGUIDLow());
+        stmt.Execute();
+        ++m_saveState.statements;
+    }
+    else
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+
+        stmt = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+                "map, position_x, position_y, position_z, orientation, "
+                "taximask, online, cinematic, "
+                "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+                "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+                "death_expire_time, taxi_path, "
+                "honor_highest_rank, honor_standing, stored_honor_rating , stored_dishonorable_kills, stored_honorable_kills, "
+                "watchedFaction, drunk, health, power1, power2, power3, "
+                "power4, power5, exploredZones, equipmentCache, ammoId, actionBars) "
+                "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,"
+                "?, ?, ?, ?, ?, "
+                "?, ?, ?, "
+                "?, ?, ?, ?, ?, ?, ?, "
+                "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                "?, ?, "
+                "?, ?, ?, ?, ?, "
+                "?, ?, ?, ?, ?, ?, "
+                "?, ?, ?, ?, ?, ?) ");
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+        stmt.addUInt32(GetGUIDLow());
+        _AddCharacterFields(stmt);
+        stmt.Execute();
+        m_saveState.statements += 2;
+        m_saveState.characterRow = true;
+    }
+
+    if (m_mailsUpdated)                                     // save mails only when needed
+        _SaveMail();
+
+    _SaveBGData();
+    _SaveInventory();
+    _SaveQuestStatus();
+    _SaveSpells();
+    _SaveSpellCooldowns();
+    _SaveActions();
+    _SaveAuras();
+    _SaveSkills();
+    _SaveNewInstanceIdTimer();
+    m_reputationMgr.SaveToDB();
+    _SaveHonorCP();
+    GetSession()->SaveTutorialsData();                      // changed only while character in game
+
+    CharacterDatabase.SetTransactionFailedFlag(m_saveState.failed);
+    CharacterDatabase.CommitTransaction();
+
+    // check if stats should only be saved on logout
+    // save stats can be out of the character transaction, in its own one to track failures
+    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
+    {
+        CharacterDatabase.BeginTransaction();
+        _SaveStats();
+        CharacterDatabase.SetTransactionFailedFlag(m_saveState.failed);
+        CharacterDatabase.CommitTransaction();
+    }
 
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, "
-                              "honor_highest_rank, honor_standing, stored_honor_rating , stored_dishonorable_kills, stored_honorable_kills, "
-                              "watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, exploredZones, equipmentCache, ammoId, actionBars) "
-                              "VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,"
-                              "?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, "
-                              "?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    sWorld.AddPlayerSaveStatements(m_saveState.statements, m_saveState.rewriteStatements);
+
+    // save pet (hunter pet level and experience and all type pets health/mana).
+    if (Pet* pet = GetPet())
+        pet->SavePetToDB(PET_SAVE_AS_CURRENT);
+}
+
+// all characters fields except guid, in the column order of SaveToDB statements
+void Player::_AddCharacterFields(SqlStatement& stmt)
+{
+    stmt.addUInt32(GetSession()->GetAccountId());
+    stmt.addString(m_name);
+    stmt.addUInt8(getRace());
+    stmt.addUInt8(getClass());
+    stmt.addUInt8(getGender());
+    stmt.addUInt32(getLevel());
+    stmt.addUInt32(GetUInt32Value(PLAYER_XP));
+    stmt.addUInt32(GetMoney());
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    stmt.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        stmt.addUInt32(GetMapId());
+        stmt.addFloat(finiteAlways(GetPositionX()));
+        stmt.addFloat(finiteAlways(GetPositionY()));
+        stmt.addFloat(finiteAlways(GetPositionZ()));
+        stmt.addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        stmt.addUInt32(GetTeleportDest().mapid);
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        stmt.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        stmt.addFloat(finiteAlways(GetTeleportDest().orientation));
     }
 
     std::ostringstream ss;
     ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
+    stmt.addUInt32(IsInWorld() ? 1 : 0);
 
-    uberInsert.addUInt32(m_cinematic);
+    stmt.addUInt32(m_cinematic);
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    stmt.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(nullptr)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    stmt.addFloat(finiteAlways(m_rest_bonus));
+    stmt.addUInt64(uint64(time(nullptr)));
+    stmt.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    stmt.addUInt32(m_resetTalentsCost);
+    stmt.addUInt64(uint64(m_resetTalentsTime));
 
     Position const* transportPosition = m_movementInfo.GetTransportPos();
-    uberInsert.addFloat(finiteAlways(transportPosition->x));
-    uberInsert.addFloat(finiteAlways(transportPosition->y));
-    uberInsert.addFloat(finiteAlways(transportPosition->z));
-    uberInsert.addFloat(finiteAlways(transportPosition->o));
+    stmt.addFloat(finiteAlways(transportPosition->x));
+    stmt.addFloat(finiteAlways(transportPosition->y));
+    stmt.addFloat(finiteAlways(transportPosition->z));
+    stmt.addFloat(finiteAlways(transportPosition->o));
 
     if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
+        stmt.addUInt32(m_transport->GetGUIDLow());
     else
-        uberInsert.addUInt32(0);
+        stmt.addUInt32(0);
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    stmt.addUInt32(m_ExtraFlags);
 
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
+    stmt.addUInt32(uint32(m_stableSlots));                  // to prevent save uint8 as char
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    stmt.addUInt32(uint32(m_atLoginFlags));
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    stmt.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    stmt.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxi.SaveTaxiDestinationsToString();       // string
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
-    uberInsert.addUInt32(uint32(m_highest_rank.rank));
-    uberInsert.addInt32(m_standing_pos);
-    uberInsert.addFloat(finiteAlways(m_stored_honor));
-    uberInsert.addUInt32(m_stored_dishonorableKills);
-    uberInsert.addUInt32(m_stored_honorableKills);
+    stmt.addUInt32(uint32(m_highest_rank.rank));
+    stmt.addInt32(m_standing_pos);
+    stmt.addFloat(finiteAlways(m_stored_honor));
+    stmt.addUInt32(m_stored_dishonorableKills);
+    stmt.addUInt32(m_stored_honorableKills);
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    stmt.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
+    stmt.addUInt16(uint16(GetUInt32Value(PLAYER_BYTES_3) & 0xFFFE));
 
-    uberInsert.addUInt32(GetHealth());
+    stmt.addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        stmt.addUInt32(GetPower(Powers(i)));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
     {
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
     }
-    uberInsert.addString(ss);
+    stmt.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END; ++i)         // string: item id, ench (perm/temp)
     {
@@ -14969,40 +15087,11 @@ void Player::SaveToDB()
         uint32 ench2 = GetUInt32Value(PLAYER_VISIBLE_ITEM_1_0 + i * MAX_VISIBLE_ITEM_OFFSET + 1 + TEMP_ENCHANTMENT_SLOT);
         ss << uint32(MAKE_PAIR32(ench1, ench2)) << " ";
     }
-    uberInsert.addString(ss);
-
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
-
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
-
-    uberInsert.Execute();
-
-    if (m_mailsUpdated)                                     // save mails only when needed
-        _SaveMail();
-
-    _SaveBGData();
-    _SaveInventory();
-    _SaveQuestStatus();
-    _SaveSpells();
-    _SaveSpellCooldowns();
-    _SaveActions();
-    _SaveAuras();
-    _SaveSkills();
-    _SaveNewInstanceIdTimer();
-    m_reputationMgr.SaveToDB();
-    _SaveHonorCP();
-    GetSession()->SaveTutorialsData();                      // changed only while character in game
+    stmt.addString(ss);
 
-    CharacterDatabase.CommitTransaction();
-
-    // check if stats should only be saved on logout
-    // save stats can be out of transaction
-    if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
-        _SaveStats();
+    stmt.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
 
-    // save pet (hunter pet level and experience and all type pets health/mana).
-    if (Pet* pet = GetPet())
-        pet->SavePetToDB(PET_SAVE_AS_CURRENT);
+    stmt.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
 }
 
 // fast save function for item/money cheating preventing - save only inventory and money state
@@ -15073,19 +15162,12 @@ void Player::_SaveActions()
 void Player::_SaveAuras()
 {
     static SqlStatementID deleteAuras ;
+    static SqlStatementID deleteAura ;
     static SqlStatementID insertAuras ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    static SqlStatementID updateAura ;
 
     SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
-
-    if (auraHolders.empty())
-        return;
-
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    PlayerSaveState::AuraMap auras;
 
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
@@ -15097,49 +15179,100 @@ void Player::_SaveAuras()
         if (!holder->IsPassive() && !IsChanneledSpell(holder->GetSpellProto()) &&
                 (trackedType == TRACK_AURA_TYPE_NOT_TRACKED || (trackedType == TRACK_AURA_TYPE_SINGLE_TARGET && selfCastHolder)))
         {
-            int32  damage[MAX_EFFECT_INDEX];
-            uint32 periodicTime[MAX_EFFECT_INDEX];
-            uint32 effIndexMask = 0;
+            PlayerSavedAura aura;
+            memset(&aura, 0, sizeof(aura));
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
             {
-                damage[i] = 0;
-                periodicTime[i] = 0;
-
                 if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
                 {
                     // don't save not own area auras
                     if (aur->IsAreaAura() && holder->GetCasterGuid() != GetObjectGuid())
                         continue;
 
-                    damage[i] = aur->GetModifier()->m_amount;
-                    periodicTime[i] = aur->GetModifier()->periodictime;
-                    effIndexMask |= (1 << i);
+                    aura.damage[i] = aur->GetModifier()->m_amount;
+                    aura.periodicTime[i] = aur->GetModifier()->periodictime;
+                    aura.effIndexMask |= (1 << i);
                 }
             }
 
-            if (!effIndexMask)
+            if (!aura.effIndexMask)
                 continue;
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            aura.stackAmount = holder->GetStackAmount();
+            aura.charges = holder->GetAuraCharges();
+            aura.maxDuration = holder->GetAuraMaxDuration();
+            aura.duration = holder->GetAuraDuration();
 
-            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addInt32(damage[i]);
+            auras[PlayerSaveState::AuraKey(holder->GetCasterGuid().GetRawValue(), holder->GetCastItemGuid().GetCounter(), holder->GetId())] = aura;
+        }
+    }
 
-            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addUInt32(periodicTime[i]);
+    m_saveState.rewriteStatements += 1 + auras.size();
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
-        }
+    // first save rewrites all rows, later saves only changed ones
+    if (!m_saveState.aurasSaved)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+        ++m_saveState.statements;
+
+        m_saveState.auras.clear();
+        m_saveState.aurasSaved = true;
+    }
+
+    for (PlayerSaveState::AuraMap::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
+    {
+        PlayerSavedAura const& aura = itr->second;
+        PlayerSaveState::AuraMap::const_iterator saved = m_saveState.auras.find(itr->first);
+        if (saved != m_saveState.auras.end() && saved->second == aura)
+            continue;
+
+        SqlStatement stmt = saved == m_saveState.auras.end() ?
+            CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (stackcount, remaincharges, "
+                "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask, "
+                "guid, caster_guid, item_guid, spell) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)") :
+            CharacterDatabase.CreateStatement(updateAura, "UPDATE character_aura SET stackcount = ?, remaincharges = ?, "
+                "basepoints0 = ?, basepoints1 = ?, basepoints2 = ?, periodictime0 = ?, periodictime1 = ?, periodictime2 = ?, maxduration = ?, remaintime = ?, effIndexMask = ? "
+                "WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+
+        stmt.addUInt32(aura.stackAmount);
+        stmt.addUInt8(uint8(aura.charges));
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+            stmt.addInt32(aura.damage[i]);
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+            stmt.addUInt32(aura.periodicTime[i]);
+
+        stmt.addInt32(aura.maxDuration);
+        stmt.addInt32(aura.duration);
+        stmt.addUInt32(aura.effIndexMask);
+
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(std::get<0>(itr->first));
+        stmt.addUInt32(std::get<1>(itr->first));
+        stmt.addUInt32(std::get<2>(itr->first));
+        stmt.Execute();
+        ++m_saveState.statements;
     }
+
+    for (PlayerSaveState::AuraMap::const_iterator itr = m_saveState.auras.begin(); itr != m_saveState.auras.end(); ++itr)
+    {
+        if (auras.find(itr->first) != auras.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAura, "DELETE FROM character_aura WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(std::get<0>(itr->first));
+        stmt.addUInt32(std::get<1>(itr->first));
+        stmt.addUInt32(std::get<2>(itr->first));
+        stmt.Execute();
+        ++m_saveState.statements;
+    }
+
+    m_saveState.auras.swap(auras);
 }
 
 void Player::_SaveInventory()
@@ -15506,33 +15639,71 @@ void Player::_SaveStats()
 
     static SqlStatementID delStats ;
     static SqlStatementID insertStats ;
+    static SqlStatementID updateStats ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    PlayerSavedStats stats;
+    memset(&stats, 0, sizeof(stats));
 
-    stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
+    stats.maxHealth = GetMaxHealth();
+    for (int i = 0; i < MAX_POWERS; ++i)
+        stats.maxPower[i] = GetMaxPower(Powers(i));
+    for (int i = 0; i < MAX_STATS; ++i)
+        stats.stat[i] = GetStat(Stats(i));
+    // armor + school resistances
+    for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
+        stats.resistance[i] = GetResistance(SpellSchools(i));
+    stats.blockPct = GetFloatValue(PLAYER_BLOCK_PERCENTAGE);
+    stats.dodgePct = GetFloatValue(PLAYER_DODGE_PERCENTAGE);
+    stats.parryPct = GetFloatValue(PLAYER_PARRY_PERCENTAGE);
+    stats.critPct = GetFloatValue(PLAYER_CRIT_PERCENTAGE);
+    stats.rangedCritPct = GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE);
+    stats.attackPower = GetUInt32Value(UNIT_FIELD_ATTACK_POWER);
+    stats.rangedAttackPower = GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER);
+
+    m_saveState.rewriteStatements += 2;
+
+    if (m_saveState.statsSaved && m_saveState.stats == stats)
+        return;
+
+    // first save rewrites the row, later saves update it in place
+    if (!m_saveState.statsSaved)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+        ++m_saveState.statements;
+    }
+
+    SqlStatement stmt = m_saveState.statsSaved ?
+        CharacterDatabase.CreateStatement(updateStats, "UPDATE character_stats SET maxhealth = ?, maxpower1 = ?, maxpower2 = ?, maxpower3 = ?, maxpower4 = ?, maxpower5 = ?, "
+            "strength = ?, agility = ?, stamina = ?, intellect = ?, spirit = ?, armor = ?, resHoly = ?, resFire = ?, resNature = ?, resFrost = ?, resShadow = ?, resArcane = ?, "
+            "blockPct = ?, dodgePct = ?, parryPct = ?, critPct = ?, rangedCritPct = ?, attackPower = ?, rangedAttackPower = ? "
+            "WHERE guid = ?") :
+        CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
             "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
-            "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
+            "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower, guid) "
             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
-    stmt.addUInt32(GetGUIDLow());
-    stmt.addUInt32(GetMaxHealth());
+    stmt.addUInt32(stats.maxHealth);
     for (int i = 0; i < MAX_POWERS; ++i)
-        stmt.addUInt32(GetMaxPower(Powers(i)));
+        stmt.addUInt32(stats.maxPower[i]);
     for (int i = 0; i < MAX_STATS; ++i)
-        stmt.addFloat(GetStat(Stats(i)));
-    // armor + school resistances
+        stmt.addFloat(stats.stat[i]);
     for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
-        stmt.addUInt32(GetResistance(SpellSchools(i)));
-    stmt.addFloat(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
+        stmt.addUInt32(stats.resistance[i]);
+    stmt.addFloat(stats.blockPct);
+    stmt.addFloat(stats.dodgePct);
+    stmt.addFloat(stats.parryPct);
+    stmt.addFloat(stats.critPct);
+    stmt.addFloat(stats.rangedCritPct);
+    stmt.addUInt32(stats.attackPower);
+    stmt.addUInt32(stats.rangedAttackPower);
+    stmt.addUInt32(GetGUIDLow());
 
     stmt.Execute();
+    ++m_saveState.statements;
+
+    m_saveState.stats = stats;
+    m_saveState.statsSaved = true;
 }
 
 void Player::outDebugStatsValues() const
@@ -16991,13 +17162,13 @@ void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* targe
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(GuidSet& s64, T* target)
+inline void UpdateVisibilityOf_helper(GuidFlatSet& s64, T* target)
 {
     s64.insert(target->GetObjectGuid());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(GuidSet& s64, GameObject* target)
+inline void UpdateVisibilityOf_helper(GuidFlatSet& s64, GameObject* target)
 {
     if (!target->IsTransport())
         s64.insert(target->GetObjectGuid());
@@ -17658,7 +17829,7 @@ void Player::UpdateForQuestWorldObjects()
 
     // UpdateData udata;
     // WorldPacket packet;
-    for (GuidSet::const_iterator itr = m_clientGUIDs.begin(); itr != m_clientGUIDs.end(); ++itr)
+    for (GuidFlatSet::const_iterator itr = m_clientGUIDs.begin(); itr != m_clientGUIDs.end(); ++itr)
     {
         if (itr->IsGameObject())
         {
@@ -19380,22 +19551,56 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
-    CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
-
-    if (m_enteredInstances.empty())
-        return;
-
+    static SqlStatementID deleteInstanceTimers;
+    static SqlStatementID deleteInstanceTimer;
     static SqlStatementID insertInsertTimer;
+    static SqlStatementID updateInstanceTimer;
+
+    PlayerSaveState::EnteredInstanceMap enteredInstances;
     for (auto enterInstItr : m_enteredInstances)
+        enteredInstances[enterInstItr.first] = uint64(Clock::to_time_t(enterInstItr.second));
+
+    m_saveState.rewriteStatements += 1 + enteredInstances.size();
+
+    // first save rewrites all rows, later saves only changed ones
+    if (!m_saveState.enteredInstancesSaved)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteInstanceTimers, "DELETE FROM account_instances_entered WHERE AccountId = ?");
+        stmt.PExecute(m_session->GetAccountId());
+        ++m_saveState.statements;
+
+        m_saveState.enteredInstances.clear();
+        m_saveState.enteredInstancesSaved = true;
+    }
+
+    for (auto& enterInstItr : enteredInstances)
     {
-        SqlStatement stmt = CharacterDatabase.CreateStatement(insertInsertTimer,
-            "INSERT INTO account_instances_entered (AccountId, ExpireTime, InstanceId) VALUES( ?, ?, ?)");
+        auto saved = m_saveState.enteredInstances.find(enterInstItr.first);
+        if (saved != m_saveState.enteredInstances.end() && saved->second == enterInstItr.second)
+            continue;
 
+        SqlStatement stmt = saved == m_saveState.enteredInstances.end() ?
+            CharacterDatabase.CreateStatement(insertInsertTimer, "INSERT INTO account_instances_entered (ExpireTime, AccountId, InstanceId) VALUES( ?, ?, ?)") :
+            CharacterDatabase.CreateStatement(updateInstanceTimer, "UPDATE account_instances_entered SET ExpireTime = ? WHERE AccountId = ? AND InstanceId = ?");
+
+        stmt.addUInt64(enterInstItr.second);
         stmt.addUInt32(m_session->GetAccountId());
-        stmt.addUInt64(Clock::to_time_t(enterInstItr.second));
         stmt.addUInt32(enterInstItr.first);
         stmt.Execute();
+        ++m_saveState.statements;
+    }
+
+    for (auto& enterInstItr : m_saveState.enteredInstances)
+    {
+        if (enteredInstances.find(enterInstItr.first) != enteredInstances.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteInstanceTimer, "DELETE FROM account_instances_entered WHERE AccountId = ? AND InstanceId = ?");
+        stmt.PExecute(m_session->GetAccountId(), enterInstItr.first);
+        ++m_saveState.statements;
     }
+
+    m_saveState.enteredInstances.swap(enteredInstances);
 }
 
 // Clears timers that expired
@@ -40,6 +40,7 @@
 #include "Server/SQLStorages.h"
 
 #include<vector>
+#include <tuple>
 
 struct Mail;
 class Channel;
@@ -792,6 +793,85 @@ struct BGData
     bool m_needSave;                                        ///< true, if saved to DB fields modified after prev. save (marked as "saved" above)
 };
 
+/// Aura row values of character_aura, key is caster guid, item guid and spell
+struct PlayerSavedAura
+{
+    uint32 stackAmount;
+    uint32 charges;
+    int32  damage[MAX_EFFECT_INDEX];
+    uint32 periodicTime[MAX_EFFECT_INDEX];
+    int32  maxDuration;
+    int32  duration;
+    uint32 effIndexMask;
+
+    bool operator==(PlayerSavedAura const& other) const { return memcmp(this, &other, sizeof(*this)) == 0; }
+};
+
+/// Cooldown row values of character_spell_cooldown, key is spell id
+struct PlayerSavedCooldown
+{
+    uint64 spellExpireTime;
+    uint64 catExpireTime;
+    uint32 category;
+    uint32 itemId;
+
+    bool operator==(PlayerSavedCooldown const& other) const { return memcmp(this, &other, sizeof(*this)) == 0; }
+};
+
+/// Row values of character_stats
+struct PlayerSavedStats
+{
+    uint32 maxHealth;
+    uint32 maxPower[MAX_POWERS];
+    float  stat[MAX_STATS];
+    uint32 resistance[MAX_SPELL_SCHOOL];
+    float  blockPct;
+    float  dodgePct;
+    float  parryPct;
+    float  critPct;
+    float  rangedCritPct;
+    uint32 attackPower;
+    uint32 rangedAttackPower;
+
+    bool operator==(PlayerSavedStats const& other) const { return memcmp(this, &other, sizeof(*this)) == 0; }
+};
+
+/// Character DB rows as written by the last save, only rows differing from them are written again
+struct PlayerSaveState
+{
+    typedef std::tuple<uint64 /*casterGuid*/, uint32 /*itemGuid*/, uint32 /*spellId*/> AuraKey;
+    typedef std::map<AuraKey, PlayerSavedAura> AuraMap;
+    typedef std::map<uint32 /*spellId*/, PlayerSavedCooldown> CooldownMap;
+    typedef std::map<uint32 /*instanceId*/, uint64 /*expireTime*/> EnteredInstanceMap;
+
+    PlayerSaveState() : characterRow(false), aurasSaved(false), cooldownsSaved(false), enteredInstancesSaved(false),
+        statsSaved(false), failed(new std::atomic<bool>(false)), statements(0), rewriteStatements(0) {}
+
+    // rows of a failed save were never written, the next save has to rewrite them all
+    void Invalidate()
+    {
+        characterRow = aurasSaved = cooldownsSaved = enteredInstancesSaved = statsSaved = false;
+        auras.clear();
+        cooldowns.clear();
+        enteredInstances.clear();
+    }
+
+    bool characterRow;                                      ///< characters row exists and is updated in place
+    bool aurasSaved;                                        ///< the containers below are valid only after a first full save
+    bool cooldownsSaved;
+    bool enteredInstancesSaved;
+    bool statsSaved;
+
+    AuraMap auras;
+    CooldownMap cooldowns;
+    EnteredInstanceMap enteredInstances;
+    PlayerSavedStats stats;
+
+    std::shared_ptr<std::atomic<bool> > failed;             ///< set by the delay thread when a save transaction is rolled back
+    uint32 statements;                                      ///< statements written by the current save
+    uint32 rewriteStatements;                               ///< statements a full delete and insert would have written
+};
+
 struct TradeStatusInfo
 {
     TradeStatusInfo() : Status(TRADE_STATUS_BUSY), TraderGuid(), Result(EQUIP_ERR_OK),
@@ -1977,9 +2057,9 @@ class Player : public Unit
         Object* GetObjectByTypeMask(ObjectGuid guid, TypeMask typemask);
 
         // currently visible objects at player client
-        GuidSet m_clientGUIDs;
+        GuidFlatSet m_clientGUIDs;
 
-        bool HaveAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.find(u->GetObjectGuid()) != m_clientGUIDs.end(); }
+        bool HaveAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.contains(u->GetObjectGuid()); }
 
         bool IsVisibleInGridForPlayer(Player* pl) const override;
         bool IsVisibleGloballyFor(Player* pl) const;
@@ -2125,6 +2205,8 @@ class Player : public Unit
         BgBattleGroundQueueID_Rec m_bgBattleGroundQueueID[PLAYER_MAX_BATTLEGROUND_QUEUES];
         BGData                    m_bgData;
 
+        PlayerSaveState           m_saveState;
+
         /*********************************************************/
         /***                    QUEST SYSTEM                   ***/
         /*********************************************************/
@@ -2172,6 +2254,7 @@ class Player : public Unit
         void _SaveSpells();
         void _SaveBGData();
         void _SaveStats();
+        void _AddCharacterFields(SqlStatement& stmt);
 
         void _SetCreateBits(UpdateMask* updateMask, Player* target) const override;
         void _SetUpdateBits(UpdateMask* updateMask, Player* target) const override;
@@ -319,6 +319,7 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procAuraFlags = 0;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -4077,6 +4078,12 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
         holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
 
+    if (uint32 procFlags = holder->GetProcFlags())
+    {
+        m_procAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+        m_procAuraFlags |= procFlags;
+    }
+
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
             AddAuraToModList(aur);
@@ -4562,6 +4569,23 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         }
     }
 
+    if (holder->GetProcFlags())
+    {
+        bounds = m_procAuraHolders.equal_range(holder->GetId());
+        for (SpellAuraHolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+        {
+            if (itr->second == holder)
+            {
+                m_procAuraHolders.erase(itr);
+                break;
+            }
+        }
+
+        m_procAuraFlags = 0;
+        for (SpellAuraHolderMap::const_iterator itr = m_procAuraHolders.begin(); itr != m_procAuraHolders.end(); ++itr)
+            m_procAuraFlags |= itr->second->GetProcFlags();
+    }
+
     holder->SetRemoveMode(mode);
     holder->UnregisterAndCleanupTrackedAuras();
 
@@ -8925,11 +8949,18 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
         }
     }
 
+    // No aura can trigger at these flags
+    if (!(procFlag & m_procAuraFlags))
+        return;
+
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders with matching proc flags can trigger
+    for (SpellAuraHolderMap::const_iterator itr = m_procAuraHolders.begin(); itr != m_procAuraHolders.end(); ++itr)
     {
+        if (!(itr->second->GetProcFlags() & procFlag))
+            continue;
+
         // skip deleted auras (possible at recursive triggered call
         if (itr->second->GetState() != SPELLAURAHOLDER_STATE_READY || itr->second->IsDeleted())
             continue;
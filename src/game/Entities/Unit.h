@@ -2157,6 +2157,8 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+        SpellAuraHolderMap m_procAuraHolders;               // holders with proc flags, in m_spellAuraHolders order
+        uint32 m_procAuraFlags;                             // all proc flags of m_procAuraHolders
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
 
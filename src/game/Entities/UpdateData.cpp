@@ -26,12 +26,16 @@
 #include "Server/Opcodes.h"
 #include "World/World.h"
 #include "Entities/ObjectGuid.h"
+#include "TSS.h"
+
+std::atomic<uint64> ValuesUpdateBlockCache::s_builtBlocks(0);
+std::atomic<uint64> ValuesUpdateBlockCache::s_reusedBlocks(0);
 
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
 
-void UpdateData::AddOutOfRangeGUID(GuidSet& guids)
+void UpdateData::AddOutOfRangeGUID(GuidFlatSet const& guids)
 {
     m_outOfRangeGUIDs.insert(guids.begin(), guids.end());
 }
@@ -47,67 +51,97 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
-{
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
-
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
-
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    if (c_stream.avail_in != 0)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflate(&c_stream, Z_FINISH);
-    if (z_res != Z_STREAM_END)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+#define UPDATE_PACKET_COMPRESS_THRESHOLD 100                // smaller packets are sent without compression
 
-    *dst_size = c_stream.total_out;
-}
+// Per thread deflate context, kept alive between packets to avoid deflateInit/deflateEnd and buffer allocations for every packet
+class UpdatePacketCompressor
+{
+    public:
+        UpdatePacketCompressor() : m_level(-1), m_buffer(0x10000) {}
+        ~UpdatePacketCompressor()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+        }
+
+        // reusable buffer for packet content before compression
+        ByteBuffer& GetBuffer() { return m_buffer; }
+
+        // compress src into packet as SMSG_COMPRESSED_UPDATE_OBJECT
+        bool Compress(WorldPacket& packet, uint8 const* src, uint32 srcSize)
+        {
+            if (!PrepareStream())
+                return false;
+
+            uint32 destSize = compressBound(srcSize);
+            packet.resize(destSize + sizeof(uint32));
+            packet.put<uint32>(0, srcSize);
+
+            m_stream.next_out = (Bytef*)(const_cast<uint8*>(packet.contents()) + sizeof(uint32));
+            m_stream.avail_out = destSize;
+            m_stream.next_in = (Bytef*)src;
+            m_stream.avail_in = (uInt)srcSize;
+
+            int z_res = deflate(&m_stream, Z_FINISH);
+            if (z_res != Z_STREAM_END)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
+                return false;
+            }
+
+            packet.resize(m_stream.total_out + sizeof(uint32));
+            packet.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+            return true;
+        }
+
+    private:
+        bool PrepareStream()
+        {
+            // default Z_BEST_SPEED (1)
+            int level = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+
+            if (m_level == level)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return true;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+
+            // first use in this thread, compression level changed at config reload or stream broken
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+
+            m_stream.zalloc = (alloc_func)nullptr;
+            m_stream.zfree = (free_func)nullptr;
+            m_stream.opaque = (voidpf)nullptr;
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                m_level = -1;
+                return false;
+            }
+
+            m_level = level;
+            return true;
+        }
+
+        z_stream m_stream;
+        int m_level;                                        // level of initialized m_stream, -1 if none
+        ByteBuffer m_buffer;
+};
+
+static MaNGOS::thread_local_ptr<UpdatePacketCompressor> s_compressor;
 
 bool UpdateData::BuildPacket(WorldPacket& packet, bool hasTransport)
 {
     MANGOS_ASSERT(packet.empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    ByteBuffer& buf = s_compressor->GetBuffer();
+    buf.clear();
 
     buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
     buf << (uint8)(hasTransport ? 1 : 0);
@@ -125,28 +159,35 @@ bool UpdateData::BuildPacket(WorldPacket& packet, bool hasTransport)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (pSize > 100)                                        // compress large packets
-    {
-        uint32 destsize = compressBound(pSize);
-        packet.resize(destsize + sizeof(uint32));
+    // compress large packets, unless the network thread does it at send
+    if (pSize > UPDATE_PACKET_COMPRESS_THRESHOLD && !sWorld.getConfig(CONFIG_BOOL_NETWORK_COMPRESS_IN_NETWORK_THREAD))
+        return s_compressor->Compress(packet, buf.contents(), pSize);
 
-        packet.put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-        if (destsize == 0)
-            return false;
-
-        packet.resize(destsize + sizeof(uint32));
-        packet.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
-    }
-    else                                                    // send small packets without compression
-    {
-        packet.append(buf);
-        packet.SetOpcode(SMSG_UPDATE_OBJECT);
-    }
+    // send small packets without compression
+    packet.append(buf);
+    packet.SetOpcode(SMSG_UPDATE_OBJECT);
 
     return true;
 }
 
+bool UpdateData::NeedsCompression(WorldPacket const& packet)
+{
+    return packet.GetOpcode() == SMSG_UPDATE_OBJECT && packet.size() > UPDATE_PACKET_COMPRESS_THRESHOLD;
+}
+
+bool UpdateData::CompressPacket(WorldPacket& packet)
+{
+    if (!NeedsCompression(packet))
+        return true;
+
+    ByteBuffer& buf = s_compressor->GetBuffer();
+    buf.clear();
+    buf.append(packet.contents(), packet.size());
+
+    packet.clear();
+    return s_compressor->Compress(packet, buf.contents(), buf.wpos());
+}
+
 void UpdateData::Clear()
 {
     m_data.clear();
@@ -22,6 +22,9 @@
 #include "ByteBuffer.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
+#include <vector>
+
 class WorldPacket;
 
 enum ObjectUpdateType
@@ -52,7 +55,7 @@ class UpdateData
     public:
         UpdateData();
 
-        void AddOutOfRangeGUID(GuidSet& guids);
+        void AddOutOfRangeGUID(GuidFlatSet const& guids);
         void AddOutOfRangeGUID(ObjectGuid const& guid);
         void AddUpdateBlock(const ByteBuffer& block);
         bool BuildPacket(WorldPacket& packet, bool hasTransport = false);
@@ -61,11 +64,45 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        // deflate SMSG_UPDATE_OBJECT content into SMSG_COMPRESSED_UPDATE_OBJECT, used by network threads
+        // when Network.CompressInNetworkThread leaves large update packets uncompressed in BuildPacket
+        static bool CompressPacket(WorldPacket& packet);
+        static bool NeedsCompression(WorldPacket const& packet);
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
+};
+
+#define VALUES_UPDATE_VIEW_UNIQUE 0xFFFFFFFF                // values block depends on observer beyond its view class, never cached
+
+// Values update blocks of one object built during a single client update pass.
+// Observers sharing the same view class (see Object::GetValuesUpdateViewKey) get the same serialized block.
+class ValuesUpdateBlockCache
+{
+    public:
+        ByteBuffer const* Find(uint32 viewKey) const
+        {
+            for (std::vector<CachedBlock>::const_iterator itr = m_blocks.begin(); itr != m_blocks.end(); ++itr)
+                if (itr->first == viewKey)
+                    return &itr->second;
+            return nullptr;
+        }
+
+        void Store(uint32 viewKey, ByteBuffer const& block) { m_blocks.push_back(CachedBlock(viewKey, block)); }
+
+        // statistics over all caches since server start
+        static void CountBuilt() { ++s_builtBlocks; }
+        static void CountReused() { ++s_reusedBlocks; }
+        static uint64 GetBuiltCount() { return s_builtBlocks; }
+        static uint64 GetReusedCount() { return s_reusedBlocks; }
+
+    private:
+        typedef std::pair<uint32, ByteBuffer> CachedBlock;
+        std::vector<CachedBlock> m_blocks;
 
-        static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+        static std::atomic<uint64> s_builtBlocks;
+        static std::atomic<uint64> s_reusedBlocks;
 };
 #endif
@@ -20,31 +20,63 @@
 #define __UPDATEMASK_H
 
 #include "Errors.h"
+#include "Entities/UpdateFields.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// players have the most update fields of all object types
+#define UPDATE_MASK_MAX_BLOCKS ((PLAYER_END + 31) / 32)
 
 class UpdateMask
 {
     public:
-        UpdateMask() : mCount(0), mBlocks(0), mUpdateMask(nullptr) { }
-        UpdateMask(const UpdateMask& mask) : mUpdateMask(nullptr) { *this = mask; }
-
-        ~UpdateMask()
-        {
-            delete[] mUpdateMask;
-        }
+        UpdateMask() : mCount(0), mBlocks(0) { }
+        UpdateMask(const UpdateMask& mask) { *this = mask; }
 
         void SetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] |= 1 << (index & 0x7);
+            mUpdateMask[index >> 5] |= 1u << (index & 0x1F);
         }
 
         void UnsetBit(uint32 index)
         {
-            ((uint8*)mUpdateMask)[ index >> 3 ] &= (0xff ^ (1 << (index & 0x7)));
+            mUpdateMask[index >> 5] &= ~(1u << (index & 0x1F));
         }
 
         bool GetBit(uint32 index) const
         {
-            return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
+            return (mUpdateMask[index >> 5] & (1u << (index & 0x1F))) != 0;
+        }
+
+        // index of the first set bit at or after index, GetCount() if there is none
+        uint32 FindNextSetBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            // ignore bits below index in the first block
+            uint32 bits = mUpdateMask[block] & (~0u << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+
+                bits = mUpdateMask[block];
+            }
+
+            return (block << 5) + CountTrailingZeros(bits);
+        }
+
+        bool IsEmpty() const
+        {
+            uint32 bits = 0;
+            for (uint32 i = 0; i < mBlocks; ++i)
+                bits |= mUpdateMask[i];
+
+            return bits == 0;
         }
 
         uint32 GetBlockCount() const { return mBlocks; }
@@ -54,24 +86,23 @@ class UpdateMask
 
         void SetCount(uint32 valuesCount)
         {
-            delete[] mUpdateMask;
+            MANGOS_ASSERT(valuesCount <= UPDATE_MASK_MAX_BLOCKS * 32);
 
             mCount = valuesCount;
             mBlocks = (valuesCount + 31) / 32;
 
-            mUpdateMask = new uint32[mBlocks];
             memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         void Clear()
         {
-            if (mUpdateMask)
-                memset(mUpdateMask, 0, mBlocks << 2);
+            memset(mUpdateMask, 0, mBlocks << 2);
         }
 
         UpdateMask& operator = (const UpdateMask& mask)
         {
-            SetCount(mask.mCount);
+            mCount = mask.mCount;
+            mBlocks = mask.mBlocks;
             memcpy(mUpdateMask, mask.mUpdateMask, mBlocks << 2);
 
             return *this;
@@ -80,23 +111,22 @@ class UpdateMask
         void operator &= (const UpdateMask& mask)
         {
             MANGOS_ASSERT(mask.mCount <= mCount);
-            for (uint32 i = 0; i < mBlocks; ++i)
+            for (uint32 i = 0; i < mask.mBlocks; ++i)
                 mUpdateMask[i] &= mask.mUpdateMask[i];
+            for (uint32 i = mask.mBlocks; i < mBlocks; ++i)
+                mUpdateMask[i] = 0;
         }
 
         void operator |= (const UpdateMask& mask)
         {
             MANGOS_ASSERT(mask.mCount <= mCount);
-            for (uint32 i = 0; i < mBlocks; ++i)
+            for (uint32 i = 0; i < mask.mBlocks; ++i)
                 mUpdateMask[i] |= mask.mUpdateMask[i];
         }
 
         UpdateMask operator & (const UpdateMask& mask) const
         {
-            MANGOS_ASSERT(mask.mCount <= mCount);
-
-            UpdateMask newmask;
-            newmask = *this;
+            UpdateMask newmask(*this);
             newmask &= mask;
 
             return newmask;
@@ -104,18 +134,26 @@ class UpdateMask
 
         UpdateMask operator | (const UpdateMask& mask) const
         {
-            MANGOS_ASSERT(mask.mCount <= mCount);
-
-            UpdateMask newmask;
-            newmask = *this;
+            UpdateMask newmask(*this);
             newmask |= mask;
 
             return newmask;
         }
 
     private:
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return index;
+#else
+            return __builtin_ctz(bits);
+#endif
+        }
+
         uint32 mCount;
         uint32 mBlocks;
-        uint32* mUpdateMask;
+        uint32 mUpdateMask[UPDATE_MASK_MAX_BLOCKS];
 };
 #endif
@@ -108,12 +108,13 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
 template<typename T>
 T IdGenerator<T>::Generate()
 {
-    if (m_nextGuid >= std::numeric_limits<T>::max() - 1)
+    T guid = m_nextGuid++;
+    if (guid >= std::numeric_limits<T>::max() - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", m_name);
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 template uint32 IdGenerator<uint32>::Generate();
@@ -388,6 +389,8 @@ struct SQLCreatureLoader : public SQLStorageLoaderBase<SQLCreatureLoader, SQLSto
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotKey() const { return sScriptDevAIMgr.GetScriptNamesHash(); }
 };
 
 void ObjectMgr::LoadCreatureTemplates()
@@ -1476,6 +1479,8 @@ struct SQLItemLoader : public SQLStorageLoaderBase<SQLItemLoader, SQLStorage>
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotKey() const { return sScriptDevAIMgr.GetScriptNamesHash(); }
 };
 
 void ObjectMgr::LoadItemPrototypes()
@@ -4208,6 +4213,8 @@ struct SQLInstanceLoader : public SQLStorageLoaderBase<SQLInstanceLoader, SQLSto
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotKey() const { return sScriptDevAIMgr.GetScriptNamesHash(); }
 };
 
 void ObjectMgr::LoadInstanceTemplate()
@@ -4299,6 +4306,8 @@ struct SQLWorldLoader : public SQLStorageLoaderBase<SQLWorldLoader, SQLStorage>
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotKey() const { return sScriptDevAIMgr.GetScriptNamesHash(); }
 };
 
 void ObjectMgr::LoadWorldTemplate()
@@ -5682,6 +5691,8 @@ struct SQLGameObjectLoader : public SQLStorageLoaderBase<SQLGameObjectLoader, SQ
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotKey() const { return sScriptDevAIMgr.GetScriptNamesHash(); }
 };
 
 inline void CheckGOLockId(GameObjectInfo const* goInfo, uint32 dataN, uint32 N)
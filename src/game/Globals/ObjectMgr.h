@@ -477,7 +477,7 @@ class IdGenerator
 
     private:                                                // fields
         char const* m_name;
-        T m_nextGuid;
+        std::atomic<T> m_nextGuid;                          // maps update in parallel and share the generators
 };
 
 class ObjectMgr
@@ -225,6 +225,9 @@ void MailDraft::CloneFrom(MailDraft const& draft)
  */
 void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, ObjectGuid receiver_guid)
 {
+    // items change their owner, keep the order with the requests of both accounts
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
+
     Player* receiver = sObjectMgr.GetPlayer(receiver_guid);
 
     uint32 rc_account = 0;
@@ -273,6 +276,9 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
  */
 void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked, uint32 deliver_delay)
 {
+    // mail and items of the receiver are written, keep the order with the requests of the receiver account
+    Database::AsyncOrderedGuard orderedGuard(CharacterDatabase);
+
     Player* pReceiver = receiver.GetPlayer();               // can be nullptr
 
     uint32 pReceiverAccount = 0;
@@ -19,6 +19,8 @@
 #include "Log.h"
 #include "Grids/CellImpl.h"
 #include "Maps/Map.h"
+#include "Maps/MapManager.h"
+#include "Maps/GridPreloader.h"
 #include "Server/DBCEnums.h"
 #include "Server/DBCStores.h"
 #include "Maps/GridMap.h"
@@ -29,6 +31,8 @@
 #include "Util.h"
 
 #include <mutex>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "z1.3";
@@ -64,6 +68,8 @@ GridMap::GridMap(): m_gridIntHeightMultiplier(0)
     m_liquidFlags = nullptr;
     m_liquidEntry = nullptr;
     m_liquid_map  = nullptr;
+
+    m_mappedFile = nullptr;
 }
 
 GridMap::~GridMap()
@@ -76,6 +82,15 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
+    // use the file contents directly from the page cache if possible, else read them
+    if (sWorld.getConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED))
+    {
+        if (loadMappedData(filename))
+            return true;
+
+        unloadData();
+    }
+
     GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -129,12 +144,21 @@ bool GridMap::loadData(char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_mappedFile)
+    {
+        // data pointers point into the mapping
+        delete m_mappedFile;
+        m_mappedFile = nullptr;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = nullptr;
     m_V9 = nullptr;
@@ -145,6 +169,132 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
+template<typename T>
+T* GridMap::getMappedData(uint32 offset, uint32 count) const
+{
+    size_t const size = m_mappedFile->get_size();
+    if (offset > size || (size - offset) / sizeof(T) < count || offset % alignof(T) != 0)
+        return nullptr;
+
+    return reinterpret_cast<T*>(static_cast<uint8*>(m_mappedFile->get_address()) + offset);
+}
+
+bool GridMap::loadMappedData(char const* filename)
+{
+    try
+    {
+        boost::interprocess::file_mapping file(filename, boost::interprocess::read_only);
+        m_mappedFile = new boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        return false;
+    }
+
+    // any problem with the file content is reported by the regular loader
+    GridMapFileHeader const* header = getMappedData<GridMapFileHeader>(0, 1);
+    if (!header || header->mapMagic != *((uint32 const*)(MAP_MAGIC)) || header->versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)))
+        return false;
+
+    if (header->areaMapOffset)
+    {
+        GridMapAreaHeader const* areaHeader = getMappedData<GridMapAreaHeader>(header->areaMapOffset, 1);
+        if (!areaHeader || areaHeader->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+            return false;
+
+        m_gridArea = areaHeader->gridArea;
+        if (!(areaHeader->flags & MAP_AREA_NO_AREA))
+        {
+            m_area_map = getMappedData<uint16>(header->areaMapOffset + sizeof(GridMapAreaHeader), 16 * 16);
+            if (!m_area_map)
+                return false;
+        }
+    }
+
+    if (header->holesOffset)
+    {
+        uint16 const* holes = getMappedData<uint16>(header->holesOffset, 16 * 16);
+        if (!holes)
+            return false;
+
+        memcpy(m_holes, holes, sizeof(m_holes));
+    }
+
+    if (header->heightMapOffset)
+    {
+        GridMapHeightHeader const* heightHeader = getMappedData<GridMapHeightHeader>(header->heightMapOffset, 1);
+        if (!heightHeader || heightHeader->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+            return false;
+
+        uint32 const dataOffset = header->heightMapOffset + sizeof(GridMapHeightHeader);
+
+        m_gridHeight = heightHeader->gridHeight;
+        if (!(heightHeader->flags & MAP_HEIGHT_NO_HEIGHT))
+        {
+            if ((heightHeader->flags & MAP_HEIGHT_AS_INT16))
+            {
+                m_uint16_V9 = getMappedData<uint16>(dataOffset, 129 * 129);
+                m_uint16_V8 = getMappedData<uint16>(dataOffset + 129 * 129 * sizeof(uint16), 128 * 128);
+                m_gridIntHeightMultiplier = (heightHeader->gridMaxHeight - heightHeader->gridHeight) / 65535;
+                m_gridGetHeight = &GridMap::getHeightFromUint16;
+            }
+            else if ((heightHeader->flags & MAP_HEIGHT_AS_INT8))
+            {
+                m_uint8_V9 = getMappedData<uint8>(dataOffset, 129 * 129);
+                m_uint8_V8 = getMappedData<uint8>(dataOffset + 129 * 129 * sizeof(uint8), 128 * 128);
+                m_gridIntHeightMultiplier = (heightHeader->gridMaxHeight - heightHeader->gridHeight) / 255;
+                m_gridGetHeight = &GridMap::getHeightFromUint8;
+            }
+            else
+            {
+                m_V9 = getMappedData<float>(dataOffset, 129 * 129);
+                m_V8 = getMappedData<float>(dataOffset + 129 * 129 * sizeof(float), 128 * 128);
+                m_gridGetHeight = &GridMap::getHeightFromFloat;
+            }
+
+            if (!m_V9 || !m_V8)
+                return false;
+        }
+        else
+            m_gridGetHeight = &GridMap::getHeightFromFlat;
+    }
+
+    if (header->liquidMapOffset)
+    {
+        GridMapLiquidHeader const* liquidHeader = getMappedData<GridMapLiquidHeader>(header->liquidMapOffset, 1);
+        if (!liquidHeader || liquidHeader->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+            return false;
+
+        m_liquidType    = liquidHeader->liquidType;
+        m_liquid_offX   = liquidHeader->offsetX;
+        m_liquid_offY   = liquidHeader->offsetY;
+        m_liquid_width  = liquidHeader->width;
+        m_liquid_height = liquidHeader->height;
+        m_liquidLevel   = liquidHeader->liquidLevel;
+
+        uint32 dataOffset = header->liquidMapOffset + sizeof(GridMapLiquidHeader);
+
+        if (!(liquidHeader->flags & MAP_LIQUID_NO_TYPE))
+        {
+            m_liquidEntry = getMappedData<uint16>(dataOffset, 16 * 16);
+            m_liquidFlags = getMappedData<uint8>(dataOffset + 16 * 16 * sizeof(uint16), 16 * 16);
+            if (!m_liquidEntry || !m_liquidFlags)
+                return false;
+
+            dataOffset += 16 * 16 * (sizeof(uint16) + sizeof(uint8));
+        }
+
+        if (!(liquidHeader->flags & MAP_LIQUID_NO_HEIGHT))
+        {
+            m_liquid_map = getMappedData<float>(dataOffset, m_liquid_width * m_liquid_height);
+            if (!m_liquid_map)
+                return false;
+        }
+    }
+
+    return true;
+}
+
 bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
@@ -1105,6 +1255,26 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y)
     return pMap;
 }
 
+GridMap* TerrainInfo::LoadGridMap(const uint32 mapId, const uint32 x, const uint32 y)
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
 GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 {
     // double checked lock pattern
@@ -1114,22 +1284,11 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
-
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
-            }
+            // files read ahead by the grid preloader only need to be activated
+            PreloadedGrid preloaded;
+            bool isPreloaded = sMapMgr.GetGridPreloader().Take(m_mapId, x, y, preloaded);
 
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
+            m_GridMaps[x][y] = isPreloaded ? preloaded.gridMap : LoadGridMap(m_mapId, x, y);
 
             // load VMAPs for current map/grid...
             const MapEntry* i_mapEntry = sMapStore.LookupEntry(m_mapId);
@@ -1150,7 +1309,7 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
             }
 
             // load navmesh
-            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+            MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y, isPreloaded ? &preloaded.navTile : nullptr);
         }
     }
 
@@ -34,6 +34,8 @@ class Group;
 class BattleGround;
 class Map;
 
+namespace boost { namespace interprocess { class mapped_region; } }
+
 struct GridMapFileHeader
 {
     uint32 mapMagic;
@@ -151,6 +153,12 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
+        // file mapping the data pointers point into, nullptr if the data was read into own buffers
+        boost::interprocess::mapped_region* m_mappedFile;
+
+        bool loadMappedData(char const* filename);
+        template<typename T> T* getMappedData(uint32 offset, uint32 count) const;
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -244,6 +252,9 @@ class TerrainInfo : public Referencable<std::atomic_long>
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
+        // reads the .map file of a grid, does not touch any shared state
+        static GridMap* LoadGridMap(const uint32 mapId, const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         // load/unload terrain data
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/GridPreloader.h"
+#include "Maps/GridMap.h"
+#include "World/World.h"
+#include "Timer.h"
+#include "Log.h"
+#include "VMapFactory.h"
+#include "vmap/VMapDefinitions.h"
+#include "vmap/ModelInstance.h"
+#include "vmap/MapTree.h"
+
+#include <cstdio>
+
+#define MAX_PRELOADED_GRIDS         32                      // queued, being read and ready grids together
+#define PRELOADED_GRID_EXPIRE_TIME  (2 * MINUTE * IN_MILLISECONDS) // read grids nobody entered meanwhile are dropped
+
+void GridPreloader::Activate()
+{
+    MANGOS_ASSERT(!IsActive());
+
+    m_cancelationToken = false;
+    m_workerThread = std::thread(&GridPreloader::WorkerThread, this);
+
+    sLog.outString("Grid preloader started");
+}
+
+void GridPreloader::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancelationToken = true;
+    }
+    m_queueCondition.notify_all();
+
+    m_workerThread.join();
+
+    for (std::unordered_map<GridKey, PreloadedGrid>::iterator itr = m_ready.begin(); itr != m_ready.end(); ++itr)
+        FreeGrid(itr->second);
+
+    m_ready.clear();
+    m_queue.clear();
+    m_scheduled.clear();
+}
+
+void GridPreloader::Schedule(uint32 mapId, uint32 x, uint32 y)
+{
+    GridKey key = MakeKey(mapId, x, y);
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if (m_scheduled.find(key) != m_scheduled.end() || m_ready.find(key) != m_ready.end())
+            return;
+
+        RemoveExpired();
+
+        if (m_scheduled.size() + m_ready.size() >= MAX_PRELOADED_GRIDS)
+            return;
+
+        m_scheduled.insert(key);
+        m_queue.push_back(key);
+    }
+    m_queueCondition.notify_one();
+}
+
+bool GridPreloader::Take(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid)
+{
+    if (!IsActive())
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::unordered_map<GridKey, PreloadedGrid>::iterator itr = m_ready.find(MakeKey(mapId, x, y));
+    if (itr == m_ready.end())
+        return false;
+
+    grid = itr->second;
+    m_ready.erase(itr);
+    return true;
+}
+
+void GridPreloader::WorkerThread()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_queueCondition.wait(guard, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+        if (m_cancelationToken)
+            return;
+
+        GridKey key = m_queue.front();
+        m_queue.pop_front();
+        guard.unlock();
+
+        PreloadedGrid grid;
+        Preload(key >> 12, (key >> 6) & 0x3F, key & 0x3F, grid);
+
+        guard.lock();
+        m_scheduled.erase(key);
+        m_ready[key] = grid;
+    }
+}
+
+void GridPreloader::Preload(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid)
+{
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Preloading grid [%u,%u] of map %u", x, y, mapId);
+
+    grid.gridMap = TerrainInfo::LoadGridMap(mapId, x, y);
+    MMAP::MMapManager::readTile(mapId, x, y, grid.navTile);
+
+    if (VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled())
+        PrefetchVMapTile(mapId, x, y);
+
+    grid.readyTime = WorldTimer::getMSTime();
+}
+
+// the vmap tree is not thread safe, only read its files so building the tile later does not wait for the disk
+void GridPreloader::PrefetchVMapTile(uint32 mapId, uint32 x, uint32 y)
+{
+    std::string basePath = sWorld.GetDataPath() + "vmaps/";
+
+    FILE* tf = fopen((basePath + VMAP::StaticMapTree::getTileFileName(mapId, x, y)).c_str(), "rb");
+    if (!tf)
+        return;
+
+    char chunk[8];
+    uint32 numSpawns;
+    if (VMAP::readChunk(tf, chunk, VMAP::VMAP_MAGIC, 8) && fread(&numSpawns, sizeof(uint32), 1, tf) == 1)
+    {
+        for (uint32 i = 0; i < numSpawns; ++i)
+        {
+            VMAP::ModelSpawn spawn;
+            uint32 referencedVal;
+            if (!VMAP::ModelSpawn::readFromFile(tf, spawn) || fread(&referencedVal, sizeof(uint32), 1, tf) != 1)
+                break;
+
+            // models are shared by many tiles and stay loaded while any of them is
+            if (m_prefetchedModels.insert(spawn.name).second)
+                PrefetchFile(basePath + spawn.name + ".vmo");
+        }
+    }
+
+    fclose(tf);
+}
+
+void GridPreloader::PrefetchFile(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return;
+
+    char buffer[64 * 1024];
+    while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+
+    fclose(file);
+}
+
+void GridPreloader::RemoveExpired()
+{
+    uint32 now = WorldTimer::getMSTime();
+
+    for (std::unordered_map<GridKey, PreloadedGrid>::iterator itr = m_ready.begin(); itr != m_ready.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second.readyTime, now) > PRELOADED_GRID_EXPIRE_TIME)
+        {
+            FreeGrid(itr->second);
+            itr = m_ready.erase(itr);
+        }
+        else
+            ++itr;
+    }
+}
+
+void GridPreloader::FreeGrid(PreloadedGrid& grid)
+{
+    if (grid.gridMap)
+    {
+        grid.gridMap->unloadData();
+        delete grid.gridMap;
+        grid.gridMap = nullptr;
+    }
+
+    dtFree(grid.navTile.data);
+    grid.navTile.data = nullptr;
+}
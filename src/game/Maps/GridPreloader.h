@@ -0,0 +1,93 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDPRELOADER_H
+#define MANGOS_GRIDPRELOADER_H
+
+#include "Common.h"
+#include "MotionGenerators/MoveMap.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+class GridMap;
+
+/// Terrain files of one grid read ahead of its loading
+struct PreloadedGrid
+{
+    PreloadedGrid() : gridMap(nullptr), readyTime(0) {}
+
+    GridMap* gridMap;                                       // loaded .map file
+    MMAP::MMapTileData navTile;                             // .mmtile, not yet added to the navmesh
+    uint32 readyTime;
+};
+
+/**
+ * Background thread reading the terrain files of grids players move towards.
+ *
+ * Maps predict the grids from the player movement (see Map::PreloadGridsAhead) and schedule them here.
+ * The thread loads the .map file, reads the .mmtile and pulls the .vmtile and the model files it
+ * references into the file system cache. TerrainInfo::LoadMapAndVMap takes the prepared data when the
+ * grid is entered, so the map update only adds the tile to the navmesh and builds the vmap tree.
+ * Creatures and gameobjects of the grid are still created by the map update, their data is in memory.
+ */
+class GridPreloader
+{
+    public:
+        GridPreloader() : m_cancelationToken(false) {}
+        ~GridPreloader() { Deactivate(); }
+
+        void Activate();
+        void Deactivate();
+        bool IsActive() const { return m_workerThread.joinable(); }
+
+        // x, y are terrain grid coordinates as used by TerrainInfo
+        void Schedule(uint32 mapId, uint32 x, uint32 y);
+        bool Take(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid);
+
+    private:
+        typedef uint32 GridKey;
+
+        static GridKey MakeKey(uint32 mapId, uint32 x, uint32 y) { return (mapId << 12) | (x << 6) | y; }
+
+        void WorkerThread();
+        void Preload(uint32 mapId, uint32 x, uint32 y, PreloadedGrid& grid);
+        void PrefetchVMapTile(uint32 mapId, uint32 x, uint32 y);
+        void RemoveExpired();                               // m_lock must be held
+
+        static void PrefetchFile(std::string const& fileName);
+        static void FreeGrid(PreloadedGrid& grid);
+
+        std::mutex m_lock;
+        std::condition_variable m_queueCondition;           // signaled when grids are queued or the thread stops
+        std::deque<GridKey> m_queue;
+        std::unordered_set<GridKey> m_scheduled;            // queued or being read
+        std::unordered_map<GridKey, PreloadedGrid> m_ready; // read, waiting for the grid to be loaded
+        bool m_cancelationToken;
+
+        std::unordered_set<std::string> m_prefetchedModels; // only used by the worker thread
+
+        std::thread m_workerThread;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/LineOfSightCache.h"
+
+#include <cmath>
+
+bool LineOfSightCache::Find(float x1, float y1, float z1, float x2, float y2, float z2, bool& result) const
+{
+    std::unordered_map<Key, bool, KeyHash>::const_iterator itr = m_results.find(MakeKey(x1, y1, z1, x2, y2, z2));
+    if (itr == m_results.end())
+        return false;
+
+    result = itr->second;
+    return true;
+}
+
+void LineOfSightCache::Insert(float x1, float y1, float z1, float x2, float y2, float z2, bool result)
+{
+    if (m_results.size() >= MAX_LINE_OF_SIGHT_CACHE_SIZE)
+        m_results.clear();
+    m_results[MakeKey(x1, y1, z1, x2, y2, z2)] = result;
+}
+
+LineOfSightCache::Key LineOfSightCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2)
+{
+    Key key;
+    key.coords[0] = int32(floor(x1 * 8.0f));
+    key.coords[1] = int32(floor(y1 * 8.0f));
+    key.coords[2] = int32(floor(z1 * 8.0f));
+    key.coords[3] = int32(floor(x2 * 8.0f));
+    key.coords[4] = int32(floor(y2 * 8.0f));
+    key.coords[5] = int32(floor(z2 * 8.0f));
+    return key;
+}
+
+size_t LineOfSightCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = 0;
+    for (int i = 0; i < 6; ++i)
+        hash = hash * 1000003 ^ size_t(uint32(key.coords[i]));
+    return hash;
+}
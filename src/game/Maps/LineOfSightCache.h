@@ -0,0 +1,59 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LINEOFSIGHTCACHE_H
+#define _LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <unordered_map>
+
+#define MAX_LINE_OF_SIGHT_CACHE_SIZE 4096                   // results kept per map and tick
+
+/// Line of sight results of the current map tick, end points quantized to 1/8 yard
+///
+/// Spell checks and target selection ask the same lines several times per tick.
+/// The owner clears the cache each tick and whenever collision geometry changes.
+class LineOfSightCache
+{
+    public:
+        /// Returns true and sets result if the line was already checked
+        bool Find(float x1, float y1, float z1, float x2, float y2, float z2, bool& result) const;
+        void Insert(float x1, float y1, float z1, float x2, float y2, float z2, bool result);
+
+        void Clear() { m_results.clear(); }
+        size_t Size() const { return m_results.size(); }
+
+    private:
+        struct Key
+        {
+            int32 coords[6];
+
+            bool operator==(Key const& other) const { return memcmp(coords, other.coords, sizeof(coords)) == 0; }
+        };
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        static Key MakeKey(float x1, float y1, float z1, float x2, float y2, float z2);
+
+        std::unordered_map<Key, bool, KeyHash> m_results;
+};
+
+#endif
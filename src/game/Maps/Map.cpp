@@ -52,9 +52,6 @@ Map::~Map()
     delete i_data;
     i_data = nullptr;
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
@@ -77,6 +74,68 @@ void Map::LoadMapAndVMap(int gx, int gy)
         m_bLoadedGrids[gx][gy] = true;
 }
 
+#define GRID_PRELOAD_INTERVAL       1000                    // ms between movement samples
+#define GRID_PRELOAD_MAX_SPEED      100.0f                  // faster position changes are teleports
+
+void Map::PreloadGridsAhead(uint32 diff)
+{
+    m_gridPreloadTimer.Update(diff);
+    if (!m_gridPreloadTimer.Passed())
+        return;
+
+    float const elapsed = m_gridPreloadTimer.GetCurrent() / float(IN_MILLISECONDS);
+    float const lookAhead = float(sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_TIME));
+    m_gridPreloadTimer.SetCurrent(0);
+
+    std::unordered_map<uint32, std::pair<float, float> > positions;
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->getSource();
+        if (!player->IsInWorld() || !player->IsPositionValid())
+            continue;
+
+        // transport passengers move with their transport, so their position covers its movement too
+        float x = player->GetPositionX();
+        float y = player->GetPositionY();
+        positions[player->GetGUIDLow()] = std::make_pair(x, y);
+
+        std::unordered_map<uint32, std::pair<float, float> >::const_iterator last = m_gridPreloadPositions.find(player->GetGUIDLow());
+        if (last == m_gridPreloadPositions.end())
+            continue;
+
+        float dx = x - last->second.first;
+        float dy = y - last->second.second;
+        float dist = sqrt(dx * dx + dy * dy);
+        if (dist < 1.0f || dist > GRID_PRELOAD_MAX_SPEED * elapsed)
+            continue;
+
+        dx /= dist;
+        dy /= dist;
+
+        // grids are loaded when they come into visibility range, not when the player enters them
+        float ahead = dist / elapsed * lookAhead + GetVisibilityDistance();
+        for (float d = GetVisibilityDistance(); d < ahead; d += SIZE_OF_GRIDS / 4)
+            PreloadGridAt(x + dx * d, y + dy * d);
+
+        PreloadGridAt(x + dx * ahead, y + dy * ahead);
+    }
+
+    m_gridPreloadPositions.swap(positions);
+}
+
+void Map::PreloadGridAt(float x, float y)
+{
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    if (p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+    if (!m_bLoadedGrids[gx][gy])
+        sMapMgr.GetGridPreloader().Schedule(GetId(), gx, gy);
+}
+
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     : i_mapEntry(sMapStore.LookupEntry(id)),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
@@ -101,6 +160,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     // lets initialize visibility distance for map
     Map::InitVisibilityDistance();
 
+    m_gridPreloadTimer.SetInterval(GRID_PRELOAD_INTERVAL);
+
     // add reference for TerrainData object
     m_TerrainData->AddRef();
 
@@ -121,6 +182,7 @@ template<class T>
 void Map::AddToGrid(T* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).template AddGridObject<T>(obj);
+    markCellOccupied(cell);
 }
 
 template<>
@@ -159,6 +221,7 @@ void Map::AddToGrid(Creature* obj, NGridType* grid, Cell const& cell)
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject<Creature>(obj);
         obj->SetCurrentCell(cell);
     }
+    markCellOccupied(cell);
 }
 
 template<class T>
@@ -275,6 +338,7 @@ bool Map::EnsureGridLoaded(const Cell& cell)
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
+        markGridCellsOccupied(cell.GridX(), cell.GridY());
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(), cell.GridY()), (*grid)(cell.CellX(), cell.CellY()), this);
@@ -373,6 +437,7 @@ void Map::MessageBroadcast(Player const* player, WorldPacket const& msg, bool to
     if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
         return;
 
+    SharedPacketGuard sharedMsg(msg);
     MaNGOS::MessageDeliverer post_man(*player, msg, to_self);
     TypeContainerVisitor<MaNGOS::MessageDeliverer, WorldTypeMapContainer > message(post_man);
     cell.Visit(p, message, *this, *player, GetVisibilityDistance());
@@ -396,6 +461,7 @@ void Map::MessageBroadcast(WorldObject const* obj, WorldPacket const& msg)
 
     // TODO: currently on continents when Visibility.Distance.InFlight > Visibility.Distance.Continents
     // we have alot of blinking mobs because monster move packet send is broken...
+    SharedPacketGuard sharedMsg(msg);
     MaNGOS::ObjectMessageDeliverer post_man(msg);
     TypeContainerVisitor<MaNGOS::ObjectMessageDeliverer, WorldTypeMapContainer > message(post_man);
     cell.Visit(p, message, *this, *obj, GetVisibilityDistance());
@@ -417,6 +483,7 @@ void Map::MessageDistBroadcast(Player const* player, WorldPacket const& msg, flo
     if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
         return;
 
+    SharedPacketGuard sharedMsg(msg);
     MaNGOS::MessageDistDeliverer post_man(*player, msg, dist, to_self, own_team_only);
     TypeContainerVisitor<MaNGOS::MessageDistDeliverer , WorldTypeMapContainer > message(post_man);
     cell.Visit(p, message, *this, *player, dist);
@@ -438,6 +505,7 @@ void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket const& msg, f
     if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
         return;
 
+    SharedPacketGuard sharedMsg(msg);
     MaNGOS::ObjectMessageDistDeliverer post_man(*obj, msg, dist);
     TypeContainerVisitor<MaNGOS::ObjectMessageDistDeliverer, WorldTypeMapContainer > message(post_man);
     cell.Visit(p, message, *this, *obj, dist);
@@ -445,6 +513,7 @@ void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket const& msg, f
 
 void Map::MessageMapBroadcast(WorldObject const* obj, WorldPacket const& msg)
 {
+    SharedPacketGuard sharedMsg(msg);
     Map::PlayerList const& pList = GetPlayers();
     for (PlayerList::const_iterator itr = pList.begin(); itr != pList.end(); ++itr)
         itr->getSource()->SendDirectMessage(msg);
@@ -518,6 +587,7 @@ bool Map::loaded(const GridPair& p) const
 void Map::Update(const uint32& t_diff)
 {
     m_dyn_tree.update(t_diff);
+    m_lineOfSightCache.Clear();
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -543,6 +613,9 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    if (sMapMgr.GetGridPreloader().IsActive())
+        PreloadGridsAhead(t_diff);
+
     /// update active cells around players and active objects
     resetMarkedCells();
 
@@ -571,7 +644,7 @@ void Map::Update(const uint32& t_diff)
                 // marked cells are those that have been visited
                 // don't visit the same cell twice
                 uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
+                if (!isCellMarked(cell_id) && isCellOccupied(cell_id))
                 {
                     markCell(cell_id);
                     CellPair pair(x, y);
@@ -579,6 +652,9 @@ void Map::Update(const uint32& t_diff)
                     cell.SetNoCreate();
                     Visit(cell, grid_object_update);
                     Visit(cell, world_object_update);
+
+                    if (!HasUpdatableObjects(cell))
+                        occupied_cells.reset(cell_id);
                 }
             }
         }
@@ -609,7 +685,7 @@ void Map::Update(const uint32& t_diff)
                     // marked cells are those that have been visited
                     // don't visit the same cell twice
                     uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
+                    if (!isCellMarked(cell_id) && isCellOccupied(cell_id))
                     {
                         markCell(cell_id);
                         CellPair pair(x, y);
@@ -617,6 +693,9 @@ void Map::Update(const uint32& t_diff)
                         cell.SetNoCreate();
                         Visit(cell, grid_object_update);
                         Visit(cell, world_object_update);
+
+                        if (!HasUpdatableObjects(cell))
+                            occupied_cells.reset(cell_id);
                     }
                 }
             }
@@ -650,6 +729,33 @@ void Map::Update(const uint32& t_diff)
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
+void Map::markGridCellsOccupied(uint32 gx, uint32 gy)
+{
+    for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+        for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+            occupied_cells.set((gy * MAX_NUMBER_OF_CELLS + y) * TOTAL_NUMBER_OF_CELLS_PER_MAP + gx * MAX_NUMBER_OF_CELLS + x);
+}
+
+/// Check for objects handled by MaNGOS::ObjectUpdater, players are updated separately
+bool Map::HasUpdatableObjects(Cell const& cell)
+{
+    if (!loaded(cell.gridPair()))
+        return false;
+
+    GridType const& gridCell = (*getNGrid(cell.GridX(), cell.GridY()))(cell.CellX(), cell.CellY());
+    return gridCell.GridObjectCount<Creature>() || gridCell.GridObjectCount<GameObject>() || gridCell.GridObjectCount<DynamicObject>() ||
+           gridCell.WorldObjectCount<Creature>();
+}
+
+void Map::UpdateWithStatistics(uint32 diff)
+{
+    TickClock::time_point startTime = TickClock::now();
+
+    Update(diff);
+
+    m_updateStatistics.Add(GetTickDurationUs(startTime));
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (i_data)
@@ -1078,12 +1184,14 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const& data) const
 {
+    SharedPacketGuard sharedData(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
         itr->getSource()->GetSession()->SendPacket(data);
 }
 
 bool Map::SendToPlayersInZone(WorldPacket const& data, uint32 zoneId) const
 {
+    SharedPacketGuard sharedData(data);
     bool foundPlayer = false;
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
     {
@@ -2058,8 +2166,15 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    bool result;
+    if (m_lineOfSightCache.Find(srcX, srcY, srcZ, destX, destY, destZ, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+
+    m_lineOfSightCache.Insert(srcX, srcY, srcZ, destX, destY, destZ, result);
+    return result;
 }
 
 /**
@@ -2157,11 +2272,13 @@ float Map::GetHeight(float x, float y, float z) const
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_lineOfSightCache.Clear();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_lineOfSightCache.Clear();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -34,6 +34,8 @@
 #include "DBScripts/ScriptMgr.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
+#include "Maps/LineOfSightCache.h"
+#include "World/WorldTickProfiler.h"
 
 #include <bitset>
 
@@ -90,6 +92,32 @@ struct WorldTemplate
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+// Tick-time statistics of a single map, all times in milliseconds, histogram in microseconds
+struct MapUpdateStatistics
+{
+    MapUpdateStatistics() : lastTime(0), maxTime(0), totalTime(0), updateCount(0) {}
+
+    void Add(uint32 timeUs)
+    {
+        histogram.Add(timeUs);
+
+        uint32 time = timeUs / 1000;
+        lastTime = time;
+        if (time > maxTime)
+            maxTime = time;
+        totalTime += time;
+        ++updateCount;
+    }
+
+    uint32 GetAverageTime() const { return updateCount ? uint32(totalTime / updateCount) : 0; }
+
+    uint32 lastTime;
+    uint32 maxTime;
+    uint64 totalTime;
+    uint32 updateCount;
+    TickHistogram histogram;
+};
+
 class Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
@@ -119,6 +147,10 @@ class Map : public GridRefManager<NGridType>
         static void DeleteFromWorld(Player* player);        // player object will deleted at call
 
         virtual void Update(const uint32&);
+        // Update() wrapper that also records the time spent, called by MapManager and its worker threads
+        void UpdateWithStatistics(uint32 diff);
+        MapUpdateStatistics const& GetUpdateStatistics() const { return m_updateStatistics; }
+        void ResetUpdateStatistics() { m_updateStatistics = MapUpdateStatistics(); }
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
@@ -197,6 +229,16 @@ class Map : public GridRefManager<NGridType>
         bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        // cells that may hold objects updated by Map::Update, empty ones are skipped there
+        bool isCellOccupied(uint32 pCellId) const { return occupied_cells.test(pCellId); }
+        void markCellOccupied(Cell const& cell)
+        {
+            CellPair pair = cell.cellPair();
+            occupied_cells.set(pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + pair.x_coord);
+        }
+        void markGridCellsOccupied(uint32 gx, uint32 gy);
+        bool HasUpdatableObjects(Cell const& cell);
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(uint32 x, uint32 y) const;
@@ -308,6 +350,10 @@ class Map : public GridRefManager<NGridType>
     private:
         void LoadMapAndVMap(int gx, int gy);
 
+        // schedules the terrain files of grids players move towards for reading in the background
+        void PreloadGridsAhead(uint32 diff);
+        void PreloadGridAt(float x, float y);
+
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
         void SendInitSelf(Player* player) const;
@@ -368,7 +414,13 @@ class Map : public GridRefManager<NGridType>
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        // player positions at the last grid preload check, the movement since then predicts the next grids
+        IntervalTimer m_gridPreloadTimer;
+        std::unordered_map<uint32, std::pair<float, float> > m_gridPreloadPositions;
+
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        // set when an object is added to the cell, cleared when the update finds nothing to update there
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> occupied_cells;
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -396,10 +448,15 @@ class Map : public GridRefManager<NGridType>
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
 
+        // line of sight results of the current tick
+        mutable LineOfSightCache m_lineOfSightCache;
+
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
 
         std::unordered_map<uint32, std::set<ObjectGuid>> m_spawnedCount;
+
+        MapUpdateStatistics m_updateStatistics;
 };
 
 class WorldMap : public Map
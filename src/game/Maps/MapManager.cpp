@@ -32,13 +32,18 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_GridStateErrorCount(0), i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_GridStateErrorCount(0), i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)),
+      i_lastMapsUpdateTime(0), i_lastMapsWorkTime(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
 
 MapManager::~MapManager()
 {
+    m_updater.Deactivate();
+    m_pathFinder.Deactivate();
+    m_gridPreloader.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -53,6 +58,15 @@ MapManager::Initialize()
 {
     InitStateMachine();
     InitMaxInstanceId();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_THREADS))
+        m_updater.Activate(numThreads);
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_PATH_FIND_ASYNC_THREADS))
+        m_pathFinder.Activate(numThreads);
+
+    if (sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_TIME))
+        m_gridPreloader.Activate();
 }
 
 void MapManager::InitStateMachine()
@@ -172,8 +186,26 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (m_updater.IsActive())
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            m_updater.ScheduleUpdate(*iter->second, (uint32)i_timer.GetCurrent());
+
+        // transports and map unloading below can touch several maps, all map updates must be done first
+        m_updater.Wait();
+    }
+    else
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->UpdateWithStatistics((uint32)i_timer.GetCurrent());
+    }
+
+    i_lastMapsUpdateTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+    i_lastMapsWorkTime = 0;
+    for (MapMapType::const_iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+        i_lastMapsWorkTime += iter->second->GetUpdateStatistics().lastTime;
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -226,6 +258,10 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    m_updater.Deactivate();
+    m_pathFinder.Deactivate();
+    m_gridPreloader.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
@@ -23,6 +23,9 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "Maps/Map.h"
+#include "Maps/MapUpdater.h"
+#include "MotionGenerators/AsyncPathFinder.h"
+#include "Maps/GridPreloader.h"
 #include "Grids/GridStates.h"
 
 class Transport;
@@ -144,7 +147,11 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
-
+        uint32 GetLastMapsUpdateTime() const { return i_lastMapsUpdateTime; }     // wall time of the last maps update
+        uint32 GetLastMapsWorkTime() const { return i_lastMapsWorkTime; }         // sum of all map update times of the last maps update
+        uint32 GetMapUpdateThreadCount() const { return m_updater.GetThreadCount(); }
+        AsyncPathFinder& GetAsyncPathFinder() { return m_pathFinder; }
+        GridPreloader& GetGridPreloader() { return m_gridPreloader; }
 
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
@@ -184,6 +191,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         IntervalTimer i_timer;
 
         uint32 i_MaxInstanceId;
+
+        MapUpdater m_updater;
+        AsyncPathFinder m_pathFinder;
+        GridPreloader m_gridPreloader;
+        uint32 i_lastMapsUpdateTime;
+        uint32 i_lastMapsWorkTime;
 };
 
 template<typename Do>
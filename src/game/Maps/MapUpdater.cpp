@@ -0,0 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapUpdater.h"
+#include "Maps/Map.h"
+#include "Log.h"
+
+void MapUpdater::Activate(uint32 numThreads)
+{
+    MANGOS_ASSERT(!IsActive());
+
+    m_cancelationToken = false;
+    m_workerThreads.reserve(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+
+    sLog.outString("Map updater started with %u worker threads", numThreads);
+}
+
+void MapUpdater::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    // let already queued updates finish, the maps would be left half updated otherwise
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancelationToken = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::thread& thread : m_workerThreads)
+        thread.join();
+
+    m_workerThreads.clear();
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back(MapUpdateRequest(map, diff));
+        ++m_pendingRequests;
+    }
+    m_queueCondition.notify_one();
+}
+
+void MapUpdater::Wait()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_doneCondition.wait(guard, [this] { return m_pendingRequests == 0; });
+}
+
+void MapUpdater::WorkerThread()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_queueCondition.wait(guard, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+        if (m_queue.empty())                                // canceled and nothing left to do
+            return;
+
+        MapUpdateRequest request = m_queue.front();
+        m_queue.pop_front();
+        guard.unlock();
+
+        request.map.UpdateWithStatistics(request.diff);
+
+        guard.lock();
+        if (--m_pendingRequests == 0)
+            m_doneCondition.notify_all();
+    }
+}
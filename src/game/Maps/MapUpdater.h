@@ -0,0 +1,74 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+class Map;
+
+/**
+ * Pool of worker threads updating independent maps concurrently.
+ *
+ * The world thread queues every map with ScheduleUpdate() and then blocks in Wait()
+ * until all queued maps are updated. Wait() acts as the barrier before anything that
+ * touches more than one map (transports, map unloading) runs.
+ */
+class MapUpdater
+{
+    public:
+        MapUpdater() : m_pendingRequests(0), m_cancelationToken(false) {}
+        ~MapUpdater() { Deactivate(); }
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActive() const { return !m_workerThreads.empty(); }
+        uint32 GetThreadCount() const { return uint32(m_workerThreads.size()); }
+
+        void ScheduleUpdate(Map& map, uint32 diff);
+        void Wait();
+
+    private:
+        struct MapUpdateRequest
+        {
+            MapUpdateRequest(Map& map, uint32 diff) : map(map), diff(diff) {}
+
+            Map& map;
+            uint32 diff;
+        };
+
+        void WorkerThread();
+
+        std::mutex m_lock;
+        std::condition_variable m_queueCondition;           // signaled when requests are queued or the pool stops
+        std::condition_variable m_doneCondition;            // signaled when the last pending request is finished
+        std::deque<MapUpdateRequest> m_queue;
+        uint32 m_pendingRequests;                           // queued + currently processed requests
+        bool m_cancelationToken;
+
+        std::vector<std::thread> m_workerThreads;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/AsyncPathFinder.h"
+#include "Log.h"
+
+void AsyncPathFinder::Activate(uint32 numThreads)
+{
+    MANGOS_ASSERT(!IsActive());
+
+    m_cancelationToken = false;
+    m_workerThreads.reserve(numThreads);
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workerThreads.push_back(std::thread(&AsyncPathFinder::WorkerThread, this));
+
+    sLog.outString("Path finder started with %u worker threads", numThreads);
+}
+
+void AsyncPathFinder::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    // workers finish the queued requests before they stop, so no owner waits forever
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancelationToken = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::thread& thread : m_workerThreads)
+        thread.join();
+
+    m_workerThreads.clear();
+}
+
+void AsyncPathFinder::Schedule(PathRequestPtr const& request)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back(request);
+    }
+    m_queueCondition.notify_one();
+}
+
+void AsyncPathFinder::WorkerThread()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_queueCondition.wait(guard, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+        if (m_queue.empty())                                // canceled and nothing left to do
+            return;
+
+        PathRequestPtr request = m_queue.front();
+        m_queue.pop_front();
+        guard.unlock();
+
+        // the owner dropped the request meanwhile (new destination or finder deleted), nobody would read the result
+        if (request.use_count() > 1)
+            request->path.BuildAsyncPath();
+
+        request->done.store(true, std::memory_order_release);
+    }
+}
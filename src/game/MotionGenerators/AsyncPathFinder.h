@@ -0,0 +1,62 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_ASYNCPATHFINDER_H
+#define MANGOS_ASYNCPATHFINDER_H
+
+#include "Common.h"
+#include "MotionGenerators/PathFinder.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+/**
+ * Pool of worker threads searching paths outside of the map update.
+ *
+ * Movement generators queue a search with PathFinder::calculateAsync() and pick the
+ * result up with PathFinder::pollAsync() on a later update. Each worker uses its own
+ * dtNavMeshQuery and holds the mesh locked against tile (un)loading while searching.
+ */
+class AsyncPathFinder
+{
+    public:
+        AsyncPathFinder() : m_cancelationToken(false) {}
+        ~AsyncPathFinder() { Deactivate(); }
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActive() const { return !m_workerThreads.empty(); }
+        uint32 GetThreadCount() const { return uint32(m_workerThreads.size()); }
+
+        void Schedule(PathRequestPtr const& request);
+
+    private:
+        void WorkerThread();
+
+        std::mutex m_lock;
+        std::condition_variable m_queueCondition;           // signaled when requests are queued or the pool stops
+        std::deque<PathRequestPtr> m_queue;
+        bool m_cancelationToken;
+
+        std::vector<std::thread> m_workerThreads;
+};
+
+#endif
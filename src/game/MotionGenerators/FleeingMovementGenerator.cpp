@@ -27,6 +27,12 @@
 #define MIN_QUIET_DISTANCE 28.0f
 #define MAX_QUIET_DISTANCE 43.0f
 
+template<class T>
+FleeingMovementGenerator<T>::~FleeingMovementGenerator()
+{
+    delete i_path;
+}
+
 template<class T>
 void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
 {
@@ -44,10 +50,22 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
 
     owner.addUnitState(UNIT_STAT_FLEEING_MOVE);
 
-    PathFinder path(&owner);
-    path.setPathLengthLimit(30.0f);
-    path.calculate(x, y, z);
-    if (path.getPathType() & PATHFIND_NOPATH)
+    // every flee point gets a fresh path, the previous one leads elsewhere
+    delete i_path;
+    i_path = new PathFinder(&owner);
+    i_path->setPathLengthLimit(30.0f);
+
+    // the path is picked up by Update once it is searched
+    if (!i_path->calculateAsync(x, y, z))
+        return;
+
+    _moveByPath(owner);
+}
+
+template<class T>
+void FleeingMovementGenerator<T>::_moveByPath(T& owner)
+{
+    if (i_path->getPathType() & PATHFIND_NOPATH)
     {
         // path not found recheck later
         i_nextCheckTime.Reset(50);
@@ -55,7 +73,7 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
     }
 
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(path.getPath());
+    init.MovebyPath(i_path->getPath());
     init.SetWalk(false);
     int32 traveltime = init.Launch();
     i_nextCheckTime.Reset(traveltime + urand(800, 1500));
@@ -179,18 +197,29 @@ bool FleeingMovementGenerator<T>::Update(T& owner, const uint32& time_diff)
     }
 
     i_nextCheckTime.Update(time_diff);
-    if (i_nextCheckTime.Passed() && owner.movespline->Finalized())
+
+    // queued path search, nothing else to do until it is finished
+    if (i_path && i_path->isCalculating())
+    {
+        if (i_path->pollAsync())
+            _moveByPath(owner);
+    }
+    else if (i_nextCheckTime.Passed() && owner.movespline->Finalized())
         _setTargetLocation(owner);
 
     return true;
 }
 
+template FleeingMovementGenerator<Player>::~FleeingMovementGenerator();
+template FleeingMovementGenerator<Creature>::~FleeingMovementGenerator();
 template void FleeingMovementGenerator<Player>::Initialize(Player&);
 template void FleeingMovementGenerator<Creature>::Initialize(Creature&);
 template bool FleeingMovementGenerator<Player>::_getPoint(Player&, float&, float&, float&);
 template bool FleeingMovementGenerator<Creature>::_getPoint(Creature&, float&, float&, float&);
 template void FleeingMovementGenerator<Player>::_setTargetLocation(Player&);
 template void FleeingMovementGenerator<Creature>::_setTargetLocation(Creature&);
+template void FleeingMovementGenerator<Player>::_moveByPath(Player&);
+template void FleeingMovementGenerator<Creature>::_moveByPath(Creature&);
 template void FleeingMovementGenerator<Player>::Interrupt(Player&);
 template void FleeingMovementGenerator<Creature>::Interrupt(Creature&);
 template void FleeingMovementGenerator<Player>::Reset(Player&);
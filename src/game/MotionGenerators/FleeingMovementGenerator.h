@@ -22,12 +22,15 @@
 #include "MovementGenerator.h"
 #include "Entities/ObjectGuid.h"
 
+class PathFinder;
+
 template<class T>
 class FleeingMovementGenerator
     : public MovementGeneratorMedium< T, FleeingMovementGenerator<T> >
 {
     public:
-        FleeingMovementGenerator(ObjectGuid fright) : i_frightGuid(fright), i_nextCheckTime(0) {}
+        FleeingMovementGenerator(ObjectGuid fright) : i_frightGuid(fright), i_nextCheckTime(0), i_path(nullptr) {}
+        ~FleeingMovementGenerator();
 
         void Initialize(T&);
         void Finalize(T&) const;
@@ -40,9 +43,11 @@ class FleeingMovementGenerator
     private:
         void _setTargetLocation(T& owner);
         bool _getPoint(T& owner, float& x, float& y, float& z);
+        void _moveByPath(T& owner);
 
         ObjectGuid i_frightGuid;
         TimeTracker i_nextCheckTime;
+        PathFinder* i_path;
 };
 
 class TimedFleeingMovementGenerator
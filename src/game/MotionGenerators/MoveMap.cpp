@@ -131,11 +131,14 @@ namespace MMAP
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
     }
 
-    bool MMapManager::loadMapData(uint32 mapId)
+    MMapData* MMapManager::loadMapData(uint32 mapId)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
+
         // we already have this map loaded?
-        if (loadedMMaps.find(mapId) != loadedMMaps.end())
-            return true;
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr != loadedMMaps.end())
+            return itr->second;
 
         // load and init dtNavMesh - read parameters from file
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i.mmap") + 1;
@@ -148,7 +151,7 @@ namespace MMAP
             if (MMapFactory::IsPathfindingEnabled(mapId))
                 sLog.outError("MMAP:loadMapData: Error: Could not open mmap file '%s'", fileName);
             delete[] fileName;
-            return false;
+            return nullptr;
         }
 
         dtNavMeshParams params;
@@ -163,7 +166,7 @@ namespace MMAP
             dtFreeNavMesh(mesh);
             sLog.outError("MMAP:loadMapData: Failed to initialize dtNavMesh for mmap %03u from file %s", mapId, fileName);
             delete[] fileName;
-            return false;
+            return nullptr;
         }
 
         delete[] fileName;
@@ -175,7 +178,15 @@ namespace MMAP
         mmap_data->mmapLoadedTiles.clear();
 
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
-        return true;
+        return mmap_data;
+    }
+
+    MMapData* MMapManager::GetMMapData(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? itr->second : nullptr;
     }
 
     uint32 MMapManager::packTileID(int32 x, int32 y) const
@@ -183,24 +194,8 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
-    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
+    bool MMapManager::readTile(uint32 mapId, int32 x, int32 y, MMapTileData& tile)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if (!loadMapData(mapId))
-            return false;
-
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        MANGOS_ASSERT(mmap->navMesh);
-
-        // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
-        {
-            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
-            return false;
-        }
-
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
@@ -241,17 +236,60 @@ namespace MMAP
         if (!result)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
+            dtFree(data);
             fclose(file);
             return false;
         }
 
         fclose(file);
 
+        tile.data = data;
+        tile.size = fileHeader.size;
+        return true;
+    }
+
+    bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y, MMapTileData* tile /*= nullptr*/)
+    {
+        MMapTileData readTileData;
+        if (!tile)
+            tile = &readTileData;
+
+        // make sure the mmap is loaded and ready to load tiles
+        MMapData* mmap = loadMapData(mapId);
+        if (!mmap)
+        {
+            dtFree(tile->data);
+            return false;
+        }
+
+        MANGOS_ASSERT(mmap->navMesh);
+
+        // check if we already have this tile loaded
+        uint32 packedGridPos = packTileID(x, y);
+        {
+            NavMeshReadGuard guard(mmap->navMeshLock);
+            if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
+            {
+                sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %03u%02i%02i.mmtile", mapId, x, y);
+                dtFree(tile->data);
+                return false;
+            }
+        }
+
+        if (!tile->data && !readTile(mapId, x, y, *tile))
+            return false;
+
+        unsigned char* data = tile->data;
+        uint32 size = tile->size;
+        tile->data = nullptr;
+
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
+        NavMeshWriteGuard guard(mmap->navMeshLock);
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        dtStatus dtResult = mmap->navMesh->addTile(data, size, DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
@@ -262,20 +300,24 @@ namespace MMAP
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
         ++loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
+
+        // cached paths may now have a shorter way through the new tile
+        mmap->pathCache.Clear();
         return true;
     }
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
+        NavMeshWriteGuard guard(mmap->navMeshLock);
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
@@ -303,6 +345,9 @@ namespace MMAP
             mmap->mmapLoadedTiles.erase(packedGridPos);
             --loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
+
+            // cached paths may lead over polygons of the removed tile
+            mmap->pathCache.Clear();
             return true;
         }
 
@@ -311,15 +356,27 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap;
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
+            std::lock_guard<std::mutex> guard(m_lock);
+
+            MMapDataSet::iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end())
+            {
+                // file may not exist, therefore not loaded
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
+                return false;
+            }
+
+            mmap = itr->second;
+            loadedMMaps.erase(itr);
         }
 
+        // wait for searches still running on this mesh, new ones can not find it anymore
+        NavMeshWriteGuard guard(mmap->navMeshLock);
+        guard.unlock();
+
         // unload all tiles from given map
-        MMapData* mmap = loadedMMaps[mapId];
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -335,69 +392,165 @@ namespace MMAP
         }
 
         delete mmap;
-        loadedMMaps.erase(mapId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = GetMMapData(mapId);
+        return mmap ? mmap->navMesh : nullptr;
+    }
+
+    dtNavMeshQuery* MMapManager::GetThreadNavMeshQuery(uint32 mapId, MMapData* mmap)
+    {
+        // m_lock must be held by the caller
+        std::thread::id threadId = std::this_thread::get_id();
+        NavMeshQuerySet::const_iterator itr = mmap->navMeshQueries.find(threadId);
+        if (itr != mmap->navMeshQueries.end())
+            return itr->second;
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        dtStatus dtResult = query->init(mmap->navMesh, 1024);
+        if (dtStatusFailed(dtResult))
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return nullptr;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u, %u queries in pool", mapId, uint32(mmap->navMeshQueries.size() + 1));
+        mmap->navMeshQueries.insert(std::pair<std::thread::id, dtNavMeshQuery*>(threadId, query));
+        return query;
+    }
+
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return GetThreadNavMeshQuery(mapId, itr->second);
+    }
+
+    bool MMapManager::AcquireNavMesh(uint32 mapId, dtNavMesh const*& navMesh, dtNavMeshQuery const*& navMeshQuery, PolyPathCache*& pathCache, NavMeshReadGuard& guard)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return false;
+
+        navMeshQuery = GetThreadNavMeshQuery(mapId, itr->second);
+        if (!navMeshQuery)
+            return false;
+
+        // taken while m_lock is held, so unloadMap can not delete the data in between
+        guard = NavMeshReadGuard(itr->second->navMeshLock);
+        navMesh = itr->second->navMesh;
+        pathCache = &itr->second->pathCache;
+        return true;
+    }
+
+    bool MMapManager::GetPolyPathCacheStats(uint32 mapId, uint32& entries, uint32& hits, uint32& misses)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return false;
+
+        itr->second->pathCache.GetStats(entries, hits, misses);
+        return true;
+    }
+
+    bool PolyPathCache::Get(PolyPathKey const& key, dtPolyRef* path, uint32& pathLength, uint32 maxPathLength, dtStatus& status)
+    {
+        if (!sWorld.getConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE))
+            return false;
+
+        Stripe& stripe = GetStripe(key);
+        std::lock_guard<std::mutex> guard(stripe.lock);
+
+        PolyPathCacheIndex::const_iterator entry = stripe.index.find(key);
+        if (entry == stripe.index.end() || entry->second->path.size() > maxPathLength)
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
+            ++m_misses;
             return false;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        ++m_hits;
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
+        // move to front, it is the most recently used one now
+        stripe.paths.splice(stripe.paths.begin(), stripe.paths, entry->second);
 
+        pathLength = uint32(entry->second->path.size());
+        memcpy(path, entry->second->path.data(), pathLength * sizeof(dtPolyRef));
+        status = entry->second->status;
         return true;
     }
 
-    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
+    void PolyPathCache::Add(PolyPathKey const& key, dtPolyRef const* path, uint32 pathLength, dtStatus status)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return nullptr;
+        uint32 cacheSize = sWorld.getConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE);
+        if (!cacheSize)
+            return;
+
+        // the configured size is shared by all stripes
+        uint32 stripeSize = std::max(cacheSize / POLY_PATH_CACHE_STRIPES, 1u);
+
+        Stripe& stripe = GetStripe(key);
+        std::lock_guard<std::mutex> guard(stripe.lock);
+
+        PolyPathCacheIndex::iterator entry = stripe.index.find(key);
+        if (entry != stripe.index.end())
+        {
+            // another thread searched the same path meanwhile
+            entry->second->path.assign(path, path + pathLength);
+            entry->second->status = status;
+            stripe.paths.splice(stripe.paths.begin(), stripe.paths, entry->second);
+            return;
+        }
 
-        return loadedMMaps[mapId]->navMesh;
+        // drop the least recently used paths, cache size may have been lowered by a config reload
+        while (stripe.index.size() >= stripeSize)
+        {
+            stripe.index.erase(stripe.paths.back().key);
+            stripe.paths.pop_back();
+        }
+
+        stripe.paths.push_front(PolyPathCacheEntry());
+        stripe.paths.front().key = key;
+        stripe.paths.front().path.assign(path, path + pathLength);
+        stripe.paths.front().status = status;
+        stripe.index[key] = stripe.paths.begin();
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    void PolyPathCache::Clear()
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return nullptr;
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        for (uint32 i = 0; i < POLY_PATH_CACHE_STRIPES; ++i)
         {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return nullptr;
-            }
+            std::lock_guard<std::mutex> guard(m_stripes[i].lock);
+            m_stripes[i].paths.clear();
+            m_stripes[i].index.clear();
+        }
+    }
 
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+    void PolyPathCache::GetStats(uint32& entries, uint32& hits, uint32& misses)
+    {
+        entries = 0;
+        for (uint32 i = 0; i < POLY_PATH_CACHE_STRIPES; ++i)
+        {
+            std::lock_guard<std::mutex> guard(m_stripes[i].lock);
+            entries += uint32(m_stripes[i].index.size());
         }
 
-        return mmap->navMeshQueries[instanceId];
+        hits = m_hits;
+        misses = m_misses;
     }
 }
@@ -20,6 +20,11 @@
 #define _MOVE_MAP_H
 
 #include "Common.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <boost/thread/shared_mutex.hpp>
 #include <Detour/Include/DetourAlloc.h>
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
@@ -41,7 +46,72 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef boost::shared_lock<boost::shared_mutex> NavMeshReadGuard;
+    typedef boost::unique_lock<boost::shared_mutex> NavMeshWriteGuard;
+
+    // poly path between two polygons found with the given filter flags
+    struct PolyPathKey
+    {
+        dtPolyRef startPoly;
+        dtPolyRef endPoly;
+        uint32 filterFlags;                 // include flags << 16 | exclude flags
+
+        bool operator==(PolyPathKey const& other) const
+        {
+            return startPoly == other.startPoly && endPoly == other.endPoly && filterFlags == other.filterFlags;
+        }
+    };
+
+    struct PolyPathKeyHash
+    {
+        size_t operator()(PolyPathKey const& key) const
+        {
+            return std::hash<uint64>()(uint64(key.startPoly) * 31 + uint64(key.endPoly)) ^ key.filterFlags;
+        }
+    };
+
+    struct PolyPathCacheEntry
+    {
+        PolyPathKey key;
+        std::vector<dtPolyRef> path;
+        dtStatus status;                    // status of the search which found the path
+    };
+
+    typedef std::list<PolyPathCacheEntry> PolyPathCacheList;   // most recently used first
+    typedef std::unordered_map<PolyPathKey, PolyPathCacheList::iterator, PolyPathKeyHash> PolyPathCacheIndex;
+
+    #define POLY_PATH_CACHE_STRIPES 16
+
+    // least recently used poly paths of one map, shared by all its instances, see PathFinder.CacheSize
+    // split by key into stripes with their own lock, so searches on parallel threads rarely wait for each other
+    // used while holding the mesh lock of the map: shared for lookups, exclusive for clearing on tile changes
+    class PolyPathCache
+    {
+        public:
+            PolyPathCache() : m_hits(0), m_misses(0) {}
+
+            bool Get(PolyPathKey const& key, dtPolyRef* path, uint32& pathLength, uint32 maxPathLength, dtStatus& status);
+            // only complete paths may be added, partial ones depend on the search limits
+            void Add(PolyPathKey const& key, dtPolyRef const* path, uint32 pathLength, dtStatus status);
+            void Clear();
+
+            void GetStats(uint32& entries, uint32& hits, uint32& misses);
+
+        private:
+            struct Stripe
+            {
+                std::mutex lock;
+                PolyPathCacheList paths;
+                PolyPathCacheIndex index;
+            };
+
+            Stripe& GetStripe(PolyPathKey const& key) { return m_stripes[PolyPathKeyHash()(key) % POLY_PATH_CACHE_STRIPES]; }
+
+            Stripe m_stripes[POLY_PATH_CACHE_STRIPES];
+            std::atomic<uint32> m_hits;
+            std::atomic<uint32> m_misses;
+    };
 
     // dummy struct to hold map's mmap data
     struct MMapData
@@ -58,14 +128,29 @@ namespace MMAP
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every thread searching this mesh gets its own
+        NavMeshQuerySet navMeshQueries;     // thread id to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+
+        // held shared by searches running outside of the map update, tiles are (un)loaded under exclusive lock
+        boost::shared_mutex navMeshLock;
+
+        // cleared whenever a tile changes
+        PolyPathCache pathCache;
     };
 
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
 
+    // navmesh tile read from its file but not yet added to a navmesh
+    struct MMapTileData
+    {
+        MMapTileData() : data(nullptr), size(0) {}
+
+        unsigned char* data;                // dtAlloc'ed, owned by the holder until added (free with dtFree)
+        uint32 size;
+    };
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
     class MMapManager
@@ -74,23 +159,35 @@ namespace MMAP
             MMapManager() : loadedTiles(0) {}
             ~MMapManager();
 
-            bool loadMap(uint32 mapId, int32 x, int32 y);
+            // tile may be read ahead with readTile, loadMap then takes over its data
+            bool loadMap(uint32 mapId, int32 x, int32 y, MMapTileData* tile = nullptr);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
+
+            // reads a tile file without touching any navmesh, safe to call from any thread
+            static bool readTile(uint32 mapId, int32 x, int32 y, MMapTileData& tile);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread and must not be shared with others
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // same as GetNavMesh and GetNavMeshQuery, but also locks the mesh against tile loading and unloading
+            // and returns the poly path cache of the map; the lock is held until the guard is released
+            bool AcquireNavMesh(uint32 mapId, dtNavMesh const*& navMesh, dtNavMeshQuery const*& navMeshQuery, PolyPathCache*& pathCache, NavMeshReadGuard& guard);
+
+            bool GetPolyPathCacheStats(uint32 mapId, uint32& entries, uint32& hits, uint32& misses);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
-            bool loadMapData(uint32 mapId);
+            MMapData* loadMapData(uint32 mapId);
+            MMapData* GetMMapData(uint32 mapId);
+            dtNavMeshQuery* GetThreadNavMeshQuery(uint32 mapId, MMapData* mmap);
             uint32 packTileID(int32 x, int32 y) const;
 
+            std::mutex m_lock;                                  // guards loadedMMaps and the query sets
             MMapDataSet loadedMMaps;
-            uint32 loadedTiles;
+            std::atomic<uint32> loadedTiles;
     };
 
     // static class
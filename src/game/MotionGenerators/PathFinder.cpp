@@ -20,6 +20,8 @@
 #include "Maps/GridMap.h"
 #include "Entities/Creature.h"
 #include "PathFinder.h"
+#include "AsyncPathFinder.h"
+#include "Maps/MapManager.h"
 #include "Log.h"
 #include "World/World.h"
 
@@ -30,28 +32,127 @@
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr)
+    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr),
+    m_mapId(owner->GetMapId()), m_sourceGuidLow(owner->GetGUIDLow()),
+    m_sourceIsCreature(owner->GetTypeId() == TYPEID_UNIT), m_canSwim(false), m_canFly(false),
+    m_startUnderWater(false), m_endUnderWater(false), m_normalizeLater(false)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
-    uint32 mapId = m_sourceUnit->GetMapId();
-    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, owner))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
-    }
+    if (MMAP::MMapFactory::IsPathfindingEnabled(m_mapId, owner))
+        m_navMesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(m_mapId);
 
     createFilter();
 }
 
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
 {
+    // a synchronous result replaces a queued one
+    m_asyncRequest.reset();
+
+    // other instances of this map load and unload tiles on parallel map threads, keep them out until the path is built
+    MMAP::NavMeshReadGuard guard;
+    dtNavMesh const* navMesh = acquireNavMesh(guard);
+
+    bool needsPolyPath;
+    bool result = prepareCalculation(destX, destY, destZ, forceDest, needsPolyPath);
+    if (result && needsPolyPath)
+        BuildPolyPath(getStartPosition(), getEndPosition());
+
+    m_navMesh = navMesh;
+    m_navMeshQuery = nullptr;
+    m_pathCache = nullptr;
+    return result;
+}
+
+dtNavMesh const* PathFinder::acquireNavMesh(MMAP::NavMeshReadGuard& guard)
+{
+    dtNavMesh const* navMesh = m_navMesh;
+
+    // queries are not thread safe, use the one of the thread updating our map
+    // without mesh or query the path is built as shortcut
+    if (m_navMesh && !MMAP::MMapFactory::createOrGetMMapManager()->AcquireNavMesh(m_mapId, m_navMesh, m_navMeshQuery, m_pathCache, guard))
+        m_navMesh = nullptr;
+
+    return navMesh;
+}
+
+bool PathFinder::calculateAsync(float destX, float destY, float destZ, bool forceDest)
+{
+    AsyncPathFinder& pathFinder = sMapMgr.GetAsyncPathFinder();
+    if (!pathFinder.IsActive())
+    {
+        calculate(destX, destY, destZ, forceDest);
+        return true;
+    }
+
+    // the result of an older search would be outdated
+    m_asyncRequest.reset();
+
+    bool needsPolyPath;
+    {
+        // tile checks need the mesh locked as well
+        MMAP::NavMeshReadGuard guard;
+        dtNavMesh const* navMesh = acquireNavMesh(guard);
+        bool result = prepareCalculation(destX, destY, destZ, forceDest, needsPolyPath);
+        m_navMesh = navMesh;
+        m_navMeshQuery = nullptr;
+        m_pathCache = nullptr;
+
+        if (!result || !needsPolyPath)
+            return true;
+    }
+
+    m_asyncRequest = std::make_shared<PathRequest>(*this);
+    m_asyncRequest->path.m_asyncRequest.reset();
+    m_asyncRequest->path.m_normalizeLater = true;
+    pathFinder.Schedule(m_asyncRequest);
+    return false;
+}
+
+bool PathFinder::pollAsync()
+{
+    if (!m_asyncRequest || !m_asyncRequest->done.load(std::memory_order_acquire))
+        return false;
+
+    PathFinder const& result = m_asyncRequest->path;
+    memcpy(m_pathPolyRefs, result.m_pathPolyRefs, result.m_polyLength * sizeof(dtPolyRef));
+    m_polyLength = result.m_polyLength;
+    m_pathPoints = result.m_pathPoints;
+    m_type = result.m_type;
+    m_actualEndPosition = result.m_actualEndPosition;
+    m_asyncRequest.reset();
+
+    NormalizePath();
+    return true;
+}
+
+void PathFinder::BuildAsyncPath()
+{
+    // runs on a pathfinding worker, the mesh stays locked against tile (un)loading until the search is done
+    MMAP::NavMeshReadGuard guard;
+    if (!MMAP::MMapFactory::createOrGetMMapManager()->AcquireNavMesh(m_mapId, m_navMesh, m_navMeshQuery, m_pathCache, guard))
+    {
+        // map was unloaded meanwhile
+        BuildShortcut();
+        m_type = PATHFIND_NOPATH;
+        return;
+    }
+
+    BuildPolyPath(getStartPosition(), getEndPosition());
+    m_navMeshQuery = nullptr;
+    m_pathCache = nullptr;
+}
+
+bool PathFinder::prepareCalculation(float destX, float destY, float destZ, bool forceDest, bool& needsPolyPath)
+{
+    needsPolyPath = false;
+
     if (!MaNGOS::IsValidMapCoord(destX, destY, destZ))
         return false;
 
@@ -68,11 +169,11 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceGuidLow);
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
+    if (!m_navMesh || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
         !HaveTile(start) || !HaveTile(dest))
     {
         BuildShortcut();
@@ -82,7 +183,18 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     updateFilter();
 
-    BuildPolyPath(start, dest);
+    // everything BuildPolyPath needs to know about the unit
+    if (m_sourceIsCreature)
+    {
+        Creature const* creature = static_cast<Creature const*>(m_sourceUnit);
+        TerrainInfo const* terrain = m_sourceUnit->GetTerrain();
+        m_canSwim = creature->CanSwim();
+        m_canFly = creature->CanFly();
+        m_startUnderWater = terrain->IsUnderWater(start.x, start.y, start.z);
+        m_endUnderWater = terrain->IsUnderWater(dest.x, dest.y, dest.z);
+    }
+
+    needsPolyPath = true;
     return true;
 }
 
@@ -174,14 +286,13 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
             // Check for swimming or flying shortcut
-            if ((startPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(startPos.x, startPos.y, startPos.z)) ||
-                    (endPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(endPos.x, endPos.y, endPos.z)))
-                m_type = ((Creature*)m_sourceUnit)->CanSwim() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+            if ((startPoly == INVALID_POLYREF && m_startUnderWater) || (endPoly == INVALID_POLYREF && m_endUnderWater))
+                m_type = m_canSwim ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
             else
-                m_type = ((Creature*)m_sourceUnit)->CanFly() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+                m_type = m_canFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         }
         else
             m_type = PATHFIND_NOPATH;
@@ -196,21 +307,18 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsUnderWater(p.x, p.y, p.z))
+            if ((distToStartPoly > 7.0f) ? m_startUnderWater : m_endUnderWater)
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_canSwim)
                     buildShotrcut = true;
             }
             else
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_canFly)
                     buildShotrcut = true;
             }
         }
@@ -269,7 +377,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
                 sLog.outError("Invalid poly ref in BuildPolyPath. polyLength: %u, pathStartIndex: %u,"
                     " startPos: %s, endPos: %s, mapId: %u",
                     m_polyLength, pathStartIndex, startPos.toString().c_str(), endPos.toString().c_str(),
-                    m_sourceUnit->GetMapId());
+                    m_mapId);
                 break;
             }
 
@@ -341,14 +449,13 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtResult = m_navMeshQuery->findPath(
+        dtResult = findPolyPath(
                        suffixStartPoly,    // start polygon
                        endPoly,            // end polygon
                        suffixEndPoint,     // start position
                        endPoint,           // end position
-                       &m_filter,            // polygon search filter
                        m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-                       (int*)&suffixPolyLength,
+                       suffixPolyLength,
                        MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
 
         if (!suffixPolyLength || dtStatusFailed(dtResult))
@@ -356,7 +463,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
         }
 
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
@@ -375,20 +482,19 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
+        dtResult = findPolyPath(
                        startPoly,          // start polygon
                        endPoly,            // end polygon
                        startPoint,         // start position
                        endPoint,           // end position
-                       &m_filter,           // polygon search filter
                        m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
+                       m_polyLength,
                        MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
             BuildShortcut();
             m_type = PATHFIND_NOPATH;
             return;
@@ -405,6 +511,29 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+dtStatus PathFinder::findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPos, const float* endPos,
+                                  dtPolyRef* path, uint32& pathSize, uint32 maxPathSize) const
+{
+    // units chasing the same target ask for the same poly path over and over, the exact
+    // positions inside start and end polygon hardly change the result
+    MMAP::PolyPathKey key;
+    key.startPoly = startPoly;
+    key.endPoly = endPoly;
+    key.filterFlags = uint32(m_filter.getIncludeFlags()) << 16 | m_filter.getExcludeFlags();
+
+    dtStatus dtResult;
+    if (m_pathCache->Get(key, path, pathSize, maxPathSize, dtResult))
+        return dtResult;
+
+    dtResult = m_navMeshQuery->findPath(startPoly, endPoly, startPos, endPos, &m_filter, path, (int*)&pathSize, maxPathSize);
+
+    // a partial path depends on the size limit and node pool of this search, later ones may find the whole path
+    if (pathSize && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) && !dtStatusDetail(dtResult, DT_BUFFER_TOO_SMALL))
+        m_pathCache->Add(key, path, pathSize, dtResult);
+
+    return dtResult;
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
@@ -545,7 +674,7 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 
 void PathFinder::NormalizePath()
 {
-    if (!sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z))
+    if (m_normalizeLater || !sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z))
         return;
 
     for (uint32 i = 0; i < m_pathPoints.size(); ++i)
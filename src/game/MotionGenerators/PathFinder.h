@@ -20,16 +20,21 @@
 #define MANGOS_PATH_FINDER_H
 
 #include "MoveMapSharedDefines.h"
+#include "MoveMap.h"
 
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
 
 #include "Movement/MoveSplineInitArgs.h"
 
+#include <atomic>
+#include <memory>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+struct PathRequest;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -68,6 +73,15 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        // Same as calculate, but the path search runs on the pathfinding worker threads when they are enabled
+        // return: true if the path is ready right away, false if the search was queued and is picked up by pollAsync()
+        // a search still queued for this finder is dropped
+        bool calculateAsync(float destX, float destY, float destZ, bool forceDest = false);
+
+        // return: true if a queued search is finished and its path was taken over, it stays queued otherwise
+        bool pollAsync();
+        bool isCalculating() const { return !!m_asyncRequest; }
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
@@ -98,10 +112,28 @@ class PathFinder
 
         const Unit* const       m_sourceUnit;       // the unit that is moving
         const dtNavMesh*        m_navMesh;          // the nav mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path, belongs to the calculating thread
+        MMAP::PolyPathCache*    m_pathCache;        // poly paths of the map, set together with the query
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
+        // source unit state taken on the map thread, the path search must not touch the unit itself
+        uint32 m_mapId;
+        uint32 m_sourceGuidLow;
+        bool m_sourceIsCreature;
+        bool m_canSwim;
+        bool m_canFly;
+        bool m_startUnderWater;
+        bool m_endUnderWater;
+
+        bool m_normalizeLater;                      // set on worker copies, NormalizePath needs the map and runs on pickup
+        std::shared_ptr<PathRequest> m_asyncRequest; // queued search, if any
+
+        bool prepareCalculation(float destX, float destY, float destZ, bool forceDest, bool& needsPolyPath);
+        // locks the mesh for the calling thread and sets its query, returns the mesh to restore afterwards
+        dtNavMesh const* acquireNavMesh(MMAP::NavMeshReadGuard& guard);
+        void BuildAsyncPath();
+
         void setStartPosition(const Vector3& point) { m_startPosition = point; }
         void setEndPosition(const Vector3& point) { m_actualEndPosition = point; m_endPosition = point; }
         void setActualEndPosition(const Vector3& point) { m_actualEndPosition = point; }
@@ -122,6 +154,8 @@ class PathFinder
         bool HaveTile(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        dtStatus findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPos, const float* endPos,
+                              dtPolyRef* path, uint32& pathSize, uint32 maxPathSize) const;
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
@@ -138,6 +172,19 @@ class PathFinder
         dtStatus findSmoothPath(const float* startPos, const float* endPos,
                                 const dtPolyRef* polyPath, uint32 polyPathSize,
                                 float* smoothPath, int* smoothPathSize, uint32 smoothPathMaxSize);
+
+        friend class AsyncPathFinder;
+};
+
+// path search queued on the AsyncPathFinder workers, done on a private copy of the owner's PathFinder
+struct PathRequest
+{
+    explicit PathRequest(PathFinder const& finder) : path(finder), done(false) {}
+
+    PathFinder path;
+    std::atomic<bool> done;
 };
 
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
 #endif
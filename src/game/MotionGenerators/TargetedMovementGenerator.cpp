@@ -62,6 +62,10 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     }
     else
     {
+        // a queued search is launched with the speed of the time it is picked up
+        if (i_path->isCalculating())
+            return;
+
         // the destination has not changed, we just need to refresh the path (usually speed change)
         G3D::Vector3 end = i_path->getEndPosition();
         x = end.x;
@@ -75,7 +79,17 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
-    i_path->calculate(x, y, z, forceDest);
+
+    // the path is picked up by Update once it is searched
+    if (!i_path->calculateAsync(x, y, z, forceDest))
+        return;
+
+    _moveByPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_moveByPath(T& owner)
+{
     if (i_path->getPathType() & PATHFIND_NOPATH)
         return;
 
@@ -130,7 +144,9 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
     if (i_recheckDistance.Passed())
     {
         i_recheckDistance.Reset(this->GetMovementGeneratorType() == FOLLOW_MOTION_TYPE ? 50 : 100);
-        G3D::Vector3 dest = owner.movespline->FinalDestination();
+        // while a search is queued the spline still ends at the old destination, compare with the queued one
+        // otherwise every recheck would replace the search before a worker gets to it
+        G3D::Vector3 dest = i_path && i_path->isCalculating() ? i_path->getEndPosition() : owner.movespline->FinalDestination();
         targetMoved = RequiresNewPosition(owner, dest.x, dest.y, dest.z);
         if (!targetMoved)
         {
@@ -152,6 +168,10 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         }
     }
 
+    // queued path search finished
+    if (i_path && i_path->isCalculating() && i_path->pollAsync())
+        _moveByPath(owner);
+
     if (m_speedChanged || targetMoved)
         _setTargetLocation(owner, targetMoved);
 
@@ -160,7 +180,8 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         if (i_angle == 0.f && !owner.HasInArc(i_target.getTarget(), 0.01f))
             owner.SetInFront(i_target.getTarget());
 
-        if (!i_targetReached)
+        // not reached while the path to the target is still searched
+        if (!i_targetReached && !(i_path && i_path->isCalculating()))
         {
             i_targetReached = true;
             static_cast<D*>(this)->_reachTarget(owner);
@@ -381,6 +402,10 @@ template void TargetedMovementGeneratorMedium<Player, ChaseMovementGenerator<Pla
 template void TargetedMovementGeneratorMedium<Player, FollowMovementGenerator<Player> >::_setTargetLocation(Player&, bool);
 template void TargetedMovementGeneratorMedium<Creature, ChaseMovementGenerator<Creature> >::_setTargetLocation(Creature&, bool);
 template void TargetedMovementGeneratorMedium<Creature, FollowMovementGenerator<Creature> >::_setTargetLocation(Creature&, bool);
+template void TargetedMovementGeneratorMedium<Player, ChaseMovementGenerator<Player> >::_moveByPath(Player&);
+template void TargetedMovementGeneratorMedium<Player, FollowMovementGenerator<Player> >::_moveByPath(Player&);
+template void TargetedMovementGeneratorMedium<Creature, ChaseMovementGenerator<Creature> >::_moveByPath(Creature&);
+template void TargetedMovementGeneratorMedium<Creature, FollowMovementGenerator<Creature> >::_moveByPath(Creature&);
 template bool TargetedMovementGeneratorMedium<Player, ChaseMovementGenerator<Player> >::Update(Player&, const uint32&);
 template bool TargetedMovementGeneratorMedium<Player, FollowMovementGenerator<Player> >::Update(Player&, const uint32&);
 template bool TargetedMovementGeneratorMedium<Creature, ChaseMovementGenerator<Creature> >::Update(Creature&, const uint32&);
@@ -0,0 +1,31 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldPacket.h"
+#include "Network/Socket.hpp"
+
+std::shared_ptr<WorldPacket const> WorldPacket::GetShared() const
+{
+    // sockets copy small content to their out buffer anyway, a shared copy would only add an allocation
+    if (!m_shared.enabled || size() < size_t(MaNGOS::Socket::SharedContentMinSize))
+        return nullptr;
+
+    if (!m_shared.packet)
+        m_shared.packet = std::make_shared<WorldPacket const>(*this);
+    return m_shared.packet;
+}
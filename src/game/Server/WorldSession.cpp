@@ -94,7 +94,7 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, time_
     _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), _security(sec), _accountId(id), _logoutTime(0),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED) {}
+    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_freePacketCount(0) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -107,6 +107,11 @@ WorldSession::~WorldSession()
     // this lets the socket handling code know that the socket can be safely deleted
     if (m_Socket)
         m_Socket->FinalizeSession();
+
+    while (WorldPacket* packet = m_recvQueue.Pop())
+        delete packet;
+    while (WorldPacket* packet = m_freePackets.Pop())
+        delete packet;
 }
 
 void WorldSession::SizeError(WorldPacket const& packet, uint32 size) const
@@ -183,8 +188,29 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-    m_recvQueue.push_back(std::move(new_packet));
+    m_recvQueue.Push(new_packet.release());
+}
+
+std::unique_ptr<WorldPacket> WorldSession::AcquirePacket(uint16 opcode, size_t size)
+{
+    if (WorldPacket* packet = m_freePackets.Pop())
+    {
+        --m_freePacketCount;
+        packet->Initialize(opcode, size);
+        return std::unique_ptr<WorldPacket>(packet);
+    }
+
+    return std::unique_ptr<WorldPacket>(new WorldPacket(opcode, size));
+}
+
+/// Keep a processed packet for reuse by the socket, oversized ones and those above the pool limit are freed
+void WorldSession::RecyclePacket(std::unique_ptr<WorldPacket> packet)
+{
+    if (!m_Socket || m_freePacketCount >= WORLD_SESSION_PACKET_POOL_SIZE || packet->capacity() > WORLD_SESSION_PACKET_POOL_CAPACITY)
+        return;
+
+    ++m_freePacketCount;
+    m_freePackets.Push(packet.release());
 }
 
 /// Logging helper for unexpected opcodes
@@ -208,14 +234,23 @@ void WorldSession::LogUnprocessedTail(WorldPacket const& packet) const
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(PacketFilter& updater)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    // keep character DB requests of this account in order
+    Database::AsyncShardGuard shardGuard(CharacterDatabase, GetAccountId());
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
+    while (m_Socket && !m_Socket->IsClosed())
     {
-        auto const packet = std::move(m_recvQueue.front());
-        m_recvQueue.pop_front();
+        // packets the updater does not process stay queued, in order, for the other updater
+        WorldPacket const* next = m_recvQueue.Peek();
+        if (!next || !updater.Process(*next))
+            break;
+
+        std::unique_ptr<WorldPacket> packet(m_recvQueue.Pop());
+        if (!packet)
+            break;
+
+        MANGOS_ASSERT(packet.get() == next);
 
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -311,6 +346,8 @@ bool WorldSession::Update(PacketFilter& updater)
                 KickPlayer();
             }
         }
+
+        RecyclePacket(std::move(packet));
     }
 
 #ifdef BUILD_PLAYERBOT
@@ -328,15 +365,20 @@ bool WorldSession::Update(PacketFilter& updater)
                 botPlayer->GetPlayerbotAI()->HandleTeleportAck();
             else if (botPlayer->IsInWorld())
             {
-                while(!pBotWorldSession->m_recvQueue.empty())
+                while (WorldPacket* botpacket = pBotWorldSession->m_recvQueue.Peek())
                 {
-                    auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
-                    pBotWorldSession->m_recvQueue.pop_front();
-
                     OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
+
+                    // thread-unsafe bot packets wait for the master's update in World::UpdateSessions()
+                    if (opHandle.packetProcessing == PROCESS_THREADUNSAFE && !updater.ProcessLogout())
+                        break;
+
+                    if (!pBotWorldSession->m_recvQueue.Pop())
+                        break;
+
+                    std::unique_ptr<WorldPacket> const packetHolder(botpacket);
                     pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
-                };
-                pBotWorldSession->m_recvQueue.clear();
+                }
             }
         }
     }
@@ -369,6 +411,8 @@ void WorldSession::LogoutPlayer(bool save)
 
     std::lock_guard<std::mutex> guard(m_logoutMutex);
 
+    Database::AsyncShardGuard shardGuard(CharacterDatabase, GetAccountId());
+
     // finish pending transfers before starting the logout
     while (_player && _player->IsBeingTeleportedFar())
         HandleMoveWorldportAckOpcode();
@@ -29,8 +29,9 @@
 #include "AuctionHouse/AuctionHouseMgr.h"
 #include "Entities/Item.h"
 #include "Server/WorldSocket.h"
+#include "Utilities/MPSCQueue.h"
 
-#include <deque>
+#include <atomic>
 #include <mutex>
 #include <memory>
 
@@ -55,6 +56,9 @@ class WorldSession;
 
 struct OpcodeHandler;
 
+#define WORLD_SESSION_PACKET_POOL_SIZE      64              // processed receive packets kept per session for reuse
+#define WORLD_SESSION_PACKET_POOL_CAPACITY  1024            // bigger packets are freed instead of kept
+
 enum PartyOperation
 {
     PARTY_OP_INVITE = 0,
@@ -179,6 +183,8 @@ class WorldSession
         void KickPlayer();
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        // new packet for the receive queue, reuses processed packets; called by the socket receive handler only
+        std::unique_ptr<WorldPacket> AcquirePacket(uint16 opcode, size_t size);
 
         bool Update(PacketFilter& updater);
 
@@ -685,8 +691,13 @@ class WorldSession
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
 
-        std::mutex m_recvQueueLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+        void RecyclePacket(std::unique_ptr<WorldPacket> packet);
+
+        // filled by network (and playerbot) threads, drained by the thread updating the session
+        MPSCQueue<WorldPacket> m_recvQueue;
+        // processed packets handed back to the socket receive handler
+        MPSCQueue<WorldPacket> m_freePackets;
+        std::atomic<uint32> m_freePacketCount;
 };
 #endif
 /// @}
@@ -31,6 +31,7 @@
 #include "Server/WorldSession.h"
 #include "Log.h"
 #include "Server/DBCStores.h"
+#include "Entities/UpdateData.h"
 
 #include <chrono>
 #include <functional>
@@ -56,7 +57,7 @@ struct ServerPktHeader
 
 WorldSocket::WorldSocket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler)
     : Socket(service, closeHandler), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0),
-      m_useExistingHeader(false), m_session(nullptr),m_seed(urand())
+      m_useExistingHeader(false), m_networkThreadPackets(0), m_session(nullptr),m_seed(urand())
 {}
 
 void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
@@ -64,6 +65,49 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     if (IsClosed())
         return;
 
+    // large update packets are still uncompressed, they are compressed and sent by the network thread.
+    // other packets are written directly, unless they would overtake a packet still waiting there
+    if (sWorld.getConfig(CONFIG_BOOL_NETWORK_COMPRESS_IN_NETWORK_THREAD))
+    {
+        std::shared_ptr<WorldSocket> self = shared<WorldSocket>();
+
+        if (UpdateData::NeedsCompression(pct))
+        {
+            std::shared_ptr<WorldPacket> packet = std::make_shared<WorldPacket>(pct);
+
+            ++m_networkThreadPackets;
+            PostToNetworkThread([self, packet, immediate]()
+            {
+                if (!self->IsClosed() && UpdateData::CompressPacket(*packet))
+                    self->SendPacketImpl(*packet, packet, immediate);
+                --self->m_networkThreadPackets;
+            });
+            return;
+        }
+
+        if (m_networkThreadPackets)
+        {
+            // broadcasts hand over the copy shared by all receivers
+            std::shared_ptr<WorldPacket const> packet = pct.GetShared();
+            if (!packet)
+                packet = std::make_shared<WorldPacket const>(pct);
+
+            ++m_networkThreadPackets;
+            PostToNetworkThread([self, packet, immediate]()
+            {
+                if (!self->IsClosed())
+                    self->SendPacketImpl(*packet, packet, immediate);
+                --self->m_networkThreadPackets;
+            });
+            return;
+        }
+    }
+
+    SendPacketImpl(pct, pct.GetShared(), immediate);
+}
+
+void WorldSocket::SendPacketImpl(const WorldPacket& pct, const std::shared_ptr<WorldPacket const>& sharedPacket, bool immediate)
+{
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
 
@@ -77,7 +121,9 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
 
     m_crypt.EncryptSend(reinterpret_cast<uint8 *>(&header), sizeof(header));
 
-    if (pct.size() > 0)
+    if (pct.size() > 0 && sharedPacket)
+        Write(reinterpret_cast<const char *>(&header), sizeof(header), std::shared_ptr<const uint8>(sharedPacket, sharedPacket->contents()), sharedPacket->size());
+    else if (pct.size() > 0)
         Write(reinterpret_cast<const char *>(&header), sizeof(header), reinterpret_cast<const char *>(pct.contents()), pct.size());
     else
         Write(reinterpret_cast<const char *>(&header), sizeof(header));
@@ -167,7 +213,7 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    std::unique_ptr<WorldPacket> pct = m_session ? m_session->AcquirePacket(opcode, validBytesRemaining) : std::unique_ptr<WorldPacket>(new WorldPacket(opcode, validBytesRemaining));
 
     if (validBytesRemaining)
     {
@@ -30,6 +30,7 @@
 #include "Auth/BigNumber.h"
 #include "Network/Socket.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 
@@ -104,6 +105,9 @@ class WorldSocket : public MaNGOS::Socket
         /// Class used for managing encryption of the headers
         AuthCrypt m_crypt;
 
+        /// Packets posted to the network thread and not written yet, later packets must follow them there
+        std::atomic<uint32> m_networkThreadPackets;
+
         /// Session to which received packets are routed
         WorldSession *m_session;
         bool m_sessionFinalized;
@@ -121,6 +125,10 @@ class WorldSocket : public MaNGOS::Socket
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket &recvPacket);
 
+        /// Encrypt header and write packet to the output buffer, the content of sharedPacket (a copy of pct or pct itself)
+        /// is referenced instead of copied when set
+        void SendPacketImpl(const WorldPacket& pct, const std::shared_ptr<WorldPacket const>& sharedPacket, bool immediate);
+
     public:
         WorldSocket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
 
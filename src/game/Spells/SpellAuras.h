@@ -151,6 +151,7 @@ class SpellAuraHolder
         uint8 GetAuraLevel() const { return m_auraLevel; }
         void SetAuraLevel(uint8 level) { m_auraLevel = level; }
         uint32 GetAuraCharges() const { return m_procCharges; }
+        uint32 GetProcFlags() const { return m_procFlags; }
         void SetAuraCharges(uint32 charges)
         {
             if (m_procCharges == charges)
@@ -207,6 +208,7 @@ class SpellAuraHolder
         uint8 m_auraSlot;                                   // Aura slot on unit (for show in client)
         uint8 m_auraLevel;                                  // Aura level (store caster level for correct show level dep amount)
         uint32 m_procCharges;                               // Aura charges (0 for infinite)
+        uint32 m_procFlags;                                 // Proc flags the aura can trigger at (0 for none)
         uint32 m_stackAmount;                               // Aura stack amount
         int32 m_maxDuration;                                // Max aura duration
         int32 m_duration;                                   // Current time
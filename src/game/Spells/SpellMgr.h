@@ -1938,6 +1938,15 @@ class SpellMgr
             return nullptr;
         }
 
+        // Proc flags an aura of the spell triggers at, custom spell_proc_event flags replace the spell ones
+        uint32 GetSpellProcFlags(SpellEntry const* spellProto) const
+        {
+            SpellProcEventEntry const* spellProcEvent = GetSpellProcEvent(spellProto->Id);
+            if (spellProcEvent && spellProcEvent->procFlags)
+                return spellProcEvent->procFlags;
+            return spellProto->procFlags;
+        }
+
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
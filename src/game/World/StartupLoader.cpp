@@ -0,0 +1,193 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+void StartupLoader::Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies)
+{
+    uint32 index = uint32(m_loaders.size());
+    m_loaders.push_back(Loader(name, function));
+
+    for (char const* dependency : dependencies)
+    {
+        uint32 depIndex = 0;
+        while (depIndex < index && strcmp(m_loaders[depIndex].name, dependency) != 0)
+            ++depIndex;
+
+        // dependencies must be added first, this also keeps the graph acyclic
+        MANGOS_ASSERT(depIndex < index);
+
+        m_loaders[index].dependencies.push_back(depIndex);
+        m_loaders[depIndex].dependents.push_back(index);
+    }
+
+    m_loaders[index].pendingDependencies = uint32(m_loaders[index].dependencies.size());
+}
+
+void StartupLoader::Execute(uint32 index)
+{
+    Loader& loader = m_loaders[index];
+
+    loader.startTime = WorldTimer::getMSTimeDiff(m_startTime, WorldTimer::getMSTime());
+    sLog.outString("Loading %s...", loader.name);
+    loader.function();
+    loader.duration = WorldTimer::getMSTimeDiff(m_startTime, WorldTimer::getMSTime()) - loader.startTime;
+}
+
+void StartupLoader::Run(uint32 numThreads)
+{
+    m_startTime = WorldTimer::getMSTime();
+
+    if (numThreads <= 1)
+    {
+        for (uint32 i = 0; i < m_loaders.size(); ++i)
+            Execute(i);
+    }
+    else
+    {
+        for (uint32 i = 0; i < m_loaders.size(); ++i)
+            if (!m_loaders[i].pendingDependencies)
+                m_ready.insert(i);
+
+        // bars of concurrent loaders would be drawn over each other
+        bool showBars = BarGoLink::GetOutputState();
+        BarGoLink::SetOutputState(false);
+
+        // the calling thread takes part as one of the workers
+        std::vector<std::thread> workerThreads;
+        for (uint32 i = 1; i < numThreads; ++i)
+            workerThreads.push_back(std::thread(&StartupLoader::WorkerThread, this, true));
+
+        WorkerThread(false);
+
+        for (std::thread& thread : workerThreads)
+            thread.join();
+
+        BarGoLink::SetOutputState(showBars);
+    }
+
+    LogReport(numThreads);
+}
+
+void StartupLoader::WorkerThread(bool startDatabases)
+{
+    if (startDatabases)
+    {
+        WorldDatabase.ThreadStart();
+        CharacterDatabase.ThreadStart();
+    }
+
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (true)
+    {
+        m_readyCondition.wait(guard, [this] { return !m_ready.empty() || m_finished == m_loaders.size(); });
+
+        if (m_ready.empty())                                // all loaders done
+            break;
+
+        uint32 index = *m_ready.begin();
+        m_ready.erase(m_ready.begin());
+        guard.unlock();
+
+        Execute(index);
+
+        guard.lock();
+        ++m_finished;
+        for (uint32 dependent : m_loaders[index].dependents)
+            if (--m_loaders[dependent].pendingDependencies == 0)
+                m_ready.insert(dependent);
+
+        // also wakes everyone when the last loader finished
+        m_readyCondition.notify_all();
+    }
+    guard.unlock();
+
+    if (startDatabases)
+    {
+        CharacterDatabase.ThreadEnd();
+        WorldDatabase.ThreadEnd();
+    }
+}
+
+void StartupLoader::LogReport(uint32 numThreads) const
+{
+    uint32 wallTime = WorldTimer::getMSTimeDiff(m_startTime, WorldTimer::getMSTime());
+    uint32 sumTime = 0;
+    for (Loader const& loader : m_loaders)
+        sumTime += loader.duration;
+
+    sLog.outString();
+    sLog.outString(">> %u startup loaders done in %u ms with %u threads (%u ms when run one by one)",
+                   uint32(m_loaders.size()), wallTime, std::max(numThreads, 1u), sumTime);
+
+    std::vector<uint32> byDuration(m_loaders.size());
+    for (uint32 i = 0; i < byDuration.size(); ++i)
+        byDuration[i] = i;
+    std::sort(byDuration.begin(), byDuration.end(), [this](uint32 left, uint32 right)
+    {
+        return m_loaders[left].duration > m_loaders[right].duration;
+    });
+
+    for (uint32 index : byDuration)
+        DETAIL_LOG("   %6u ms  %s", m_loaders[index].duration, m_loaders[index].name);
+
+    // the critical path ends in the loader finishing last and follows the dependency that finished last
+    if (m_loaders.empty())
+        return;
+
+    uint32 current = 0;
+    for (uint32 i = 1; i < m_loaders.size(); ++i)
+        if (m_loaders[i].startTime + m_loaders[i].duration > m_loaders[current].startTime + m_loaders[current].duration)
+            current = i;
+
+    std::vector<uint32> path;
+    while (true)
+    {
+        path.push_back(current);
+
+        Loader const& loader = m_loaders[current];
+        if (loader.dependencies.empty())
+            break;
+
+        current = loader.dependencies.front();
+        for (uint32 dependency : loader.dependencies)
+            if (m_loaders[dependency].startTime + m_loaders[dependency].duration > m_loaders[current].startTime + m_loaders[current].duration)
+                current = dependency;
+    }
+
+    uint32 pathTime = 0;
+    std::string pathStr;
+    for (std::vector<uint32>::const_reverse_iterator itr = path.rbegin(); itr != path.rend(); ++itr)
+    {
+        if (!pathStr.empty())
+            pathStr += " -> ";
+        pathStr += m_loaders[*itr].name;
+        pathTime += m_loaders[*itr].duration;
+    }
+
+    sLog.outString(">> Critical path (%u ms): %s", pathTime, pathStr.c_str());
+    sLog.outString();
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_STARTUPLOADER_H
+#define MANGOS_STARTUPLOADER_H
+
+#include "Common.h"
+
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <vector>
+
+/**
+ * Runs world startup loaders along their declared dependencies.
+ *
+ * A loader may only depend on loaders added before it, so running them in the order
+ * of Add() is always valid and is what happens with a single thread. With more threads
+ * every loader whose dependencies are finished is started on the next free thread.
+ * Loaders without a dependency between them must not touch the same data.
+ */
+class StartupLoader
+{
+    public:
+        typedef std::function<void()> LoadFunction;
+
+        StartupLoader() : m_finished(0), m_startTime(0) {}
+
+        void Add(char const* name, LoadFunction function, std::initializer_list<char const*> dependencies = {});
+
+        // Runs all added loaders and logs their timings and the critical path
+        void Run(uint32 numThreads);
+
+    private:
+        struct Loader
+        {
+            Loader(char const* name, LoadFunction function) : name(name), function(function), pendingDependencies(0), startTime(0), duration(0) {}
+
+            char const* name;
+            LoadFunction function;
+            std::vector<uint32> dependencies;
+            std::vector<uint32> dependents;
+            uint32 pendingDependencies;
+            uint32 startTime;                               // ms since Run() start
+            uint32 duration;
+        };
+
+        void Execute(uint32 index);
+        void WorkerThread(bool startDatabases);             // false for the thread calling Run()
+        void LogReport(uint32 numThreads) const;
+
+        std::vector<Loader> m_loaders;
+
+        std::mutex m_lock;
+        std::condition_variable m_readyCondition;           // signaled when loaders become ready or all are finished
+        std::set<uint32> m_ready;                           // ready loaders, started in Add() order
+        uint32 m_finished;
+        uint32 m_startTime;
+};
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "World/World.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SQLStorage.h"
 #include "Config/Config.h"
 #include "Platform/Define.h"
 #include "SystemConfig.h"
@@ -64,6 +65,8 @@
 #include "Tools/CharacterDatabaseCleaner.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Weather/Weather.h"
+#include "World/WorldTickProfiler.h"
+#include "World/StartupLoader.h"
 
 #include <algorithm>
 #include <mutex>
@@ -103,6 +106,12 @@ World::World(): mail_timer(0), mail_timer_expires(0)
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
     m_MaintenanceTimeChecker = 0;
+    m_playerSaves = 0;
+    m_playerSaveStatements = 0;
+    m_playerSaveRewriteStatements = 0;
+    m_lastPlayerSaves = 0;
+    m_lastPlayerSaveStatements = 0;
+    m_lastPlayerSaveRewriteStatements = 0;
 
     m_defaultDbcLocale = LOCALE_enUS;
     m_availableDbcLocaleMask = 0;
@@ -455,6 +464,10 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
+    setConfig(CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED, "MapFiles.MemoryMapped", true);
+
+    if (configNoReload(reload, CONFIG_UINT32_GRID_PRELOAD_TIME, "GridPreloadTime", 0))
+        setConfig(CONFIG_UINT32_GRID_PRELOAD_TIME, "GridPreloadTime", 0);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
@@ -479,6 +492,12 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    if (configNoReload(reload, CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdate.Threads", 0))
+        setConfig(CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdate.Threads", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_LOAD_THREADS, "Startup.LoadThreads", 0))
+        setConfig(CONFIG_UINT32_LOAD_THREADS, "Startup.LoadThreads", 0);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -666,6 +685,9 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
 
+    if (configNoReload(reload, CONFIG_BOOL_NETWORK_COMPRESS_IN_NETWORK_THREAD, "Network.CompressInNetworkThread", false))
+        setConfig(CONFIG_BOOL_NETWORK_COMPRESS_IN_NETWORK_THREAD, "Network.CompressInNetworkThread", false);
+
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
     setConfig(CONFIG_UINT32_INSTANT_LOGOUT, "InstantLogout", SEC_MODERATOR);
@@ -776,6 +798,12 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    ///- Read the directory for binary world table snapshots, empty disables them
+    std::string snapshotDir = sConfig.GetStringDefault("SnapshotDir", "");
+    SQLStorageBase::SetSnapshotDir(snapshotDir);
+    if (!reload && !snapshotDir.empty())
+        sLog.outString("Using SnapshotDir %s", snapshotDir.c_str());
+
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
@@ -799,6 +827,10 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
 
+    if (configNoReload(reload, CONFIG_UINT32_PATH_FIND_ASYNC_THREADS, "PathFinder.AsyncThreads", 0))
+        setConfig(CONFIG_UINT32_PATH_FIND_ASYNC_THREADS, "PathFinder.AsyncThreads", 0);
+    setConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE, "PathFinder.CacheSize", 1024);
+
     sLog.outString();
 }
 
@@ -888,129 +920,50 @@ void World::SetInitialWorldSettings()
     sObjectMgr.SetHighestGuids();                           // must be after packing instances
     sLog.outString();
 
-    sLog.outString("Loading Page Texts...");
-    sObjectMgr.LoadPageTexts();
-
-    sLog.outString("Loading Game Object Templates...");     // must be after LoadPageTexts
-    sObjectMgr.LoadGameobjectInfo();
-
-    sLog.outString("Loading GameObject models...");
-    LoadGameObjectModelList();
-    sLog.outString();
-
-    sLog.outString("Loading Spell Chain Data...");
-    sSpellMgr.LoadSpellChains();
-
-    sLog.outString("Loading Spell Elixir types...");
-    sSpellMgr.LoadSpellElixirs();
-
-    sLog.outString("Loading Spell Facing Flags...");
-    sSpellMgr.LoadFacingCasterFlags();
-
-    sLog.outString("Loading Spell Learn Skills...");
-    sSpellMgr.LoadSpellLearnSkills();                       // must be after LoadSpellChains
-
-    sLog.outString("Loading Spell Learn Spells...");
-    sSpellMgr.LoadSpellLearnSpells();
-
-    sLog.outString("Loading Spell Proc Event conditions...");
-    sSpellMgr.LoadSpellProcEvents();
-
-    sLog.outString("Loading Spell Bonus Data...");
-    sSpellMgr.LoadSpellBonuses();
-
-    sLog.outString("Loading Spell Proc Item Enchant...");
-    sSpellMgr.LoadSpellProcItemEnchant();                   // must be after LoadSpellChains
-
-    sLog.outString("Loading Aggro Spells Definitions...");
-    sSpellMgr.LoadSpellThreats();
-
-    sLog.outString("Loading NPC Texts...");
-    sObjectMgr.LoadGossipText();
-
-    sLog.outString("Loading Item Random Enchantments Table...");
-    LoadRandomEnchantmentsTable();
-
-    sLog.outString("Loading Item Templates...");            // must be after LoadRandomEnchantmentsTable and LoadPageTexts
-    sObjectMgr.LoadItemPrototypes();
-
-    sLog.outString("Loading Item Texts...");
-    sObjectMgr.LoadItemTexts();
-
-    sLog.outString("Loading Creature Model Based Info Data...");
-    sObjectMgr.LoadCreatureModelInfo();
-
-    sLog.outString("Loading Equipment templates...");
-    sObjectMgr.LoadEquipmentTemplates();
-
-    sLog.outString("Loading Creature Stats...");
-    sObjectMgr.LoadCreatureClassLvlStats();
-
-    sLog.outString("Loading Creature templates...");
-    sObjectMgr.LoadCreatureTemplates();
-
-    sLog.outString("Loading Creature template spells...");
-    sObjectMgr.LoadCreatureTemplateSpells();
-
-    sLog.outString("Loading SpellsScriptTarget...");
-    sSpellMgr.LoadSpellScriptTarget();                      // must be after LoadCreatureTemplates and LoadGameobjectInfo
-
-    sLog.outString("Loading ItemRequiredTarget...");
-    sObjectMgr.LoadItemRequiredTarget();
-
-    sLog.outString("Loading Reputation Reward Rates...");
-    sObjectMgr.LoadReputationRewardRate();
-
-    sLog.outString("Loading Creature Reputation OnKill Data...");
-    sObjectMgr.LoadReputationOnKill();
-
-    sLog.outString("Loading Reputation Spillover Data...");
-    sObjectMgr.LoadReputationSpilloverTemplate();
-
-    sLog.outString("Loading Points Of Interest Data...");
-    sObjectMgr.LoadPointsOfInterest();
-
-    sLog.outString("Loading Pet Create Spells...");
-    sObjectMgr.LoadPetCreateSpells();
-
-    sLog.outString("Loading Creature Data...");
-    sObjectMgr.LoadCreatures();
-
-    sLog.outString("Loading Creature Addon Data...");
-    sObjectMgr.LoadCreatureAddons();                        // must be after LoadCreatureTemplates() and LoadCreatures()
-    sLog.outString(">>> Creature Addon Data loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Gameobject Data...");
-    sObjectMgr.LoadGameObjects();
-
-    sLog.outString("Loading CreatureLinking Data...");      // must be after Creatures
-    sCreatureLinkingMgr.LoadFromDB();
-
-    sLog.outString("Loading Objects Pooling Data...");
-    sPoolMgr.LoadFromDB();
-
-    sLog.outString("Loading Weather Data...");
-    sWeatherMgr.LoadWeatherZoneChances();
-
-    sLog.outString("Loading Quests...");
-    sObjectMgr.LoadQuests();                                // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    sLog.outString("Loading Quests Relations...");
-    sObjectMgr.LoadQuestRelations();                        // must be after quest load
-    sLog.outString(">>> Quests Relations loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Game Event Data...");           // must be after sPoolMgr.LoadFromDB and quests to properly load pool events and quests for events
-    sGameEventMgr.LoadFromDB();
-    sLog.outString(">>> Game Event Data loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Dungeon Encounters...");
-    sObjectMgr.LoadDungeonEncounters();                     // Load DungeonEncounter.dbc from DB
-
-    sLog.outString("Loading Conditions...");                // Load Conditions
-    sObjectMgr.LoadConditions();
+    ///- Independent world data loaders run concurrently with Startup.LoadThreads > 1
+    ///- Loaders without dependency between them must not touch the same containers
+    StartupLoader loader;
+    loader.Add("Page Texts", [] { sObjectMgr.LoadPageTexts(); });
+    loader.Add("Game Object Templates", [] { sObjectMgr.LoadGameobjectInfo(); }, { "Page Texts" });
+    loader.Add("GameObject models", [] { LoadGameObjectModelList(); });
+    loader.Add("Spell Chain Data", [] { sSpellMgr.LoadSpellChains(); });
+    loader.Add("Spell Elixir types", [] { sSpellMgr.LoadSpellElixirs(); });
+    loader.Add("Spell Facing Flags", [] { sSpellMgr.LoadFacingCasterFlags(); });
+    loader.Add("Spell Learn Skills", [] { sSpellMgr.LoadSpellLearnSkills(); }, { "Spell Chain Data" });
+    loader.Add("Spell Learn Spells", [] { sSpellMgr.LoadSpellLearnSpells(); }, { "Spell Chain Data" });
+    loader.Add("Spell Proc Event conditions", [] { sSpellMgr.LoadSpellProcEvents(); }, { "Spell Chain Data" });
+    loader.Add("Spell Bonus Data", [] { sSpellMgr.LoadSpellBonuses(); }, { "Spell Chain Data" });
+    loader.Add("Spell Proc Item Enchant", [] { sSpellMgr.LoadSpellProcItemEnchant(); }, { "Spell Chain Data" });
+    loader.Add("Aggro Spells Definitions", [] { sSpellMgr.LoadSpellThreats(); }, { "Spell Chain Data" });
+    loader.Add("NPC Texts", [] { sObjectMgr.LoadGossipText(); });
+    loader.Add("Item Random Enchantments Table", [] { LoadRandomEnchantmentsTable(); });
+    loader.Add("Item Templates", [] { sObjectMgr.LoadItemPrototypes(); }, { "Item Random Enchantments Table", "Page Texts" });
+    loader.Add("Item Texts", [] { sObjectMgr.LoadItemTexts(); });
+    loader.Add("Creature Model Based Info Data", [] { sObjectMgr.LoadCreatureModelInfo(); });
+    loader.Add("Equipment templates", [] { sObjectMgr.LoadEquipmentTemplates(); }, { "Item Templates" });
+    loader.Add("Creature Stats", [] { sObjectMgr.LoadCreatureClassLvlStats(); });
+    loader.Add("Creature templates", [] { sObjectMgr.LoadCreatureTemplates(); }, { "Creature Model Based Info Data", "Equipment templates", "Creature Stats" });
+    loader.Add("Creature template spells", [] { sObjectMgr.LoadCreatureTemplateSpells(); }, { "Creature templates" });
+    loader.Add("SpellsScriptTarget", [] { sSpellMgr.LoadSpellScriptTarget(); }, { "Creature templates", "Game Object Templates" });
+    loader.Add("ItemRequiredTarget", [] { sObjectMgr.LoadItemRequiredTarget(); }, { "Item Templates", "Creature templates", "SpellsScriptTarget" });
+    loader.Add("Reputation Reward Rates", [] { sObjectMgr.LoadReputationRewardRate(); });
+    loader.Add("Creature Reputation OnKill Data", [] { sObjectMgr.LoadReputationOnKill(); }, { "Creature templates" });
+    loader.Add("Reputation Spillover Data", [] { sObjectMgr.LoadReputationSpilloverTemplate(); });
+    loader.Add("Points Of Interest Data", [] { sObjectMgr.LoadPointsOfInterest(); });
+    loader.Add("Pet Create Spells", [] { sObjectMgr.LoadPetCreateSpells(); }, { "Creature templates" });
+    loader.Add("Creature Data", [] { sObjectMgr.LoadCreatures(); }, { "Creature templates" });
+    loader.Add("Creature Addon Data", [] { sObjectMgr.LoadCreatureAddons(); }, { "Creature Data" });
+    // shares the per cell guid sets with creatures
+    loader.Add("Gameobject Data", [] { sObjectMgr.LoadGameObjects(); }, { "Game Object Templates", "Creature Data" });
+    loader.Add("CreatureLinking Data", [] { sCreatureLinkingMgr.LoadFromDB(); }, { "Creature Data" });
+    loader.Add("Objects Pooling Data", [] { sPoolMgr.LoadFromDB(); }, { "Creature Data", "Gameobject Data" });
+    loader.Add("Weather Data", [] { sWeatherMgr.LoadWeatherZoneChances(); });
+    loader.Add("Quests", [] { sObjectMgr.LoadQuests(); }, { "Item Templates", "Creature templates", "Game Object Templates" });
+    loader.Add("Quests Relations", [] { sObjectMgr.LoadQuestRelations(); }, { "Quests", "Creature Data", "Gameobject Data" });
+    loader.Add("Game Event Data", [] { sGameEventMgr.LoadFromDB(); }, { "Objects Pooling Data", "Quests Relations" });
+    loader.Add("Dungeon Encounters", [] { sObjectMgr.LoadDungeonEncounters(); });
+    loader.Add("Conditions", [] { sObjectMgr.LoadConditions(); }, { "Game Event Data", "Creature Addon Data", "CreatureLinking Data", "ItemRequiredTarget" });
+    loader.Run(getConfig(CONFIG_UINT32_LOAD_THREADS));
 
     sLog.outString("Creating map persistent states for non-instanceable maps...");     // must be after PackInstances(), LoadCreatures(), sPoolMgr.LoadFromDB(), sGameEventMgr.LoadFromDB();
     sMapPersistentStateMgr.InitWorldMaps();
@@ -1233,6 +1186,9 @@ void World::SetInitialWorldSettings()
     // Update groups with offline leader after delay in seconds
     m_timers[WUPDATE_GROUPS].SetInterval(IN_MILLISECONDS);
 
+    // Collect player save statistics once per autosave interval
+    m_timers[WUPDATE_PLAYER_SAVES].SetInterval(getConfig(CONFIG_UINT32_INTERVAL_SAVE));
+
     // to set mailtimer to return mails every day between 4 and 5 am
     // mailtimer is increased when updating auctions
     // one second is 1000 -(tested on win system)
@@ -1354,6 +1310,8 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    TICK_PROFILE_PHASE(TICK_PHASE_TOTAL);
+
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 
     ///- Update the different timers
@@ -1374,6 +1332,7 @@ void World::Update(uint32 diff)
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
+        TICK_PROFILE_PHASE(TICK_PHASE_AUCTIONS);
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
@@ -1391,12 +1350,16 @@ void World::Update(uint32 diff)
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
     {
+        TICK_PROFILE_PHASE(TICK_PHASE_AHBOT);
         sAuctionBot.Update();
         m_timers[WUPDATE_AHBOT].Reset();
     }
 
     /// <li> Handle session updates
-    UpdateSessions(diff);
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_SESSIONS);
+        UpdateSessions(diff);
+    }
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
@@ -1410,9 +1373,18 @@ void World::Update(uint32 diff)
 
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
-    sMapMgr.Update(diff);
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_MAPS);
+        sMapMgr.Update(diff);
+    }
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_BATTLEGROUNDS);
+        sBattleGroundMgr.Update(diff);
+    }
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_OUTDOORPVP);
+        sOutdoorPvPMgr.Update(diff);
+    }
 
     ///- Update groups with offline leaders
     if (m_timers[WUPDATE_GROUPS].Passed())
@@ -1425,6 +1397,19 @@ void World::Update(uint32 diff)
         }
     }
 
+    ///- Sum up player saves of the finished autosave interval
+    if (m_timers[WUPDATE_PLAYER_SAVES].Passed())
+    {
+        m_timers[WUPDATE_PLAYER_SAVES].Reset();
+        m_lastPlayerSaves = m_playerSaves.exchange(0);
+        m_lastPlayerSaveStatements = m_playerSaveStatements.exchange(0);
+        m_lastPlayerSaveRewriteStatements = m_playerSaveRewriteStatements.exchange(0);
+
+        if (m_lastPlayerSaves)
+            DETAIL_LOG("Autosave interval: %u player saves, %u character DB statements instead of %u",
+                       m_lastPlayerSaves, m_lastPlayerSaveStatements, m_lastPlayerSaveRewriteStatements);
+    }
+
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1433,7 +1418,10 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
-    UpdateResultQueue();
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_SQL_CALLBACKS);
+        UpdateResultQueue();
+    }
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1446,6 +1434,7 @@ void World::Update(uint32 diff)
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
+        TICK_PROFILE_PHASE(TICK_PHASE_GAME_EVENTS);
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr.Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
@@ -1454,7 +1443,10 @@ void World::Update(uint32 diff)
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
-    sMapMgr.RemoveAllObjectsInRemoveList();
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_REMOVE_LIST);
+        sMapMgr.RemoveAllObjectsInRemoveList();
+    }
 
     // update the instance reset times
     sMapPersistentStateMgr.Update();
@@ -1472,10 +1464,16 @@ void World::Update(uint32 diff)
         m_MaintenanceTimeChecker -= diff;
 
     // And last, but not least handle the issued cli commands
-    ProcessCliCommands();
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_CLI_COMMANDS);
+        ProcessCliCommands();
+    }
 
     // cleanup unused GridMap objects as well as VMaps
-    sTerrainMgr.Update(diff);
+    {
+        TICK_PROFILE_PHASE(TICK_PHASE_TERRAIN);
+        sTerrainMgr.Update(diff);
+    }
 }
 
 namespace MaNGOS
@@ -1547,6 +1545,7 @@ void World::SendWorldText(int32 string_id, ...)
 /// Sends a packet to all players with optional team and instance restrictions
 void World::SendGlobalMessage(WorldPacket const& packet) const
 {
+    SharedPacketGuard sharedPacket(packet);
     for (SessionMap::const_iterator itr = m_sessions.cbegin(); itr != m_sessions.cend(); ++itr)
     {
         if (WorldSession* session = itr->second)
@@ -1611,6 +1610,20 @@ void World::SendDefenseMessage(uint32 zoneId, int32 textId)
     }
 }
 
+void World::AddPlayerSaveStatements(uint32 statements, uint32 rewriteStatements)
+{
+    ++m_playerSaves;
+    m_playerSaveStatements += statements;
+    m_playerSaveRewriteStatements += rewriteStatements;
+}
+
+void World::GetPlayerSaveStatistics(uint32& saves, uint32& statements, uint32& rewriteStatements) const
+{
+    saves = m_lastPlayerSaves;
+    statements = m_lastPlayerSaveStatements;
+    rewriteStatements = m_lastPlayerSaveRewriteStatements;
+}
+
 /// Kick (and save) all players
 void World::KickAll()
 {
@@ -32,6 +32,7 @@
 #include <list>
 #include <deque>
 #include <mutex>
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -69,14 +70,15 @@ enum ShutdownExitCode
 /// Timers for different object refresh rates
 enum WorldTimers
 {
-    WUPDATE_AUCTIONS    = 0,
-    WUPDATE_UPTIME      = 1,
-    WUPDATE_CORPSES     = 2,
-    WUPDATE_EVENTS      = 3,
-    WUPDATE_DELETECHARS = 4,
-    WUPDATE_AHBOT       = 5,
-    WUPDATE_GROUPS      = 6,
-    WUPDATE_COUNT       = 7
+    WUPDATE_AUCTIONS     = 0,
+    WUPDATE_UPTIME       = 1,
+    WUPDATE_CORPSES      = 2,
+    WUPDATE_EVENTS       = 3,
+    WUPDATE_DELETECHARS  = 4,
+    WUPDATE_AHBOT        = 5,
+    WUPDATE_GROUPS       = 6,
+    WUPDATE_PLAYER_SAVES = 7,
+    WUPDATE_COUNT        = 8
 };
 
 /// Configuration elements
@@ -85,7 +87,12 @@ enum eConfigUInt32Values
     CONFIG_UINT32_COMPRESSION = 0,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
+    CONFIG_UINT32_GRID_PRELOAD_TIME,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAP_UPDATE_THREADS,
+    CONFIG_UINT32_LOAD_THREADS,
+    CONFIG_UINT32_PATH_FIND_ASYNC_THREADS,
+    CONFIG_UINT32_PATH_FIND_CACHE_SIZE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -267,6 +274,7 @@ enum eConfigFloatValues
 enum eConfigBoolValues
 {
     CONFIG_BOOL_GRID_UNLOAD = 0,
+    CONFIG_BOOL_MAP_FILES_MEMORY_MAPPED,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
     CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_CHAT,
@@ -309,6 +317,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_OUTDOORPVP_SI_ENABLED,
     CONFIG_BOOL_OUTDOORPVP_EP_ENABLED,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_NETWORK_COMPRESS_IN_NETWORK_THREAD,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
@@ -409,6 +418,11 @@ class World
         uint32 GetMaxQueuedSessionCount() const { return m_maxQueuedSessionCount; }
         uint32 GetMaxActiveSessionCount() const { return m_maxActiveSessionCount; }
 
+        /// Count character DB statements of a player save, and the statements rewriting all its rows would take
+        void AddPlayerSaveStatements(uint32 statements, uint32 rewriteStatements);
+        /// Get the player save counters of the last completed autosave interval
+        void GetPlayerSaveStatistics(uint32& saves, uint32& statements, uint32& rewriteStatements) const;
+
         /// Get the active session server limit (or security level limitations)
         uint32 GetPlayerAmountLimit() const { return m_playerLimit >= 0 ? m_playerLimit : 0; }
         AccountTypes GetPlayerSecurityLimit() const { return m_playerLimit <= 0 ? AccountTypes(-m_playerLimit) : SEC_PLAYER; }
@@ -606,6 +620,14 @@ class World
         uint32 m_maxActiveSessionCount;
         uint32 m_maxQueuedSessionCount;
 
+        // player saves of the running autosave interval, counted from map threads
+        std::atomic<uint32> m_playerSaves;
+        std::atomic<uint32> m_playerSaveStatements;
+        std::atomic<uint32> m_playerSaveRewriteStatements;
+        uint32 m_lastPlayerSaves;
+        uint32 m_lastPlayerSaveStatements;
+        uint32 m_lastPlayerSaveRewriteStatements;
+
         uint32 m_configUint32Values[CONFIG_UINT32_VALUE_COUNT];
         int32 m_configInt32Values[CONFIG_INT32_VALUE_COUNT];
         float m_configFloatValues[CONFIG_FLOAT_VALUE_COUNT];
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/WorldTickProfiler.h"
+#include "World/World.h"
+#include "Policies/Singleton.h"
+#include "Database/DatabaseEnv.h"
+#include "Entities/UpdateData.h"
+#include "Maps/MapManager.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <fstream>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+void TickHistogram::Reset()
+{
+    memset(m_samples, 0, sizeof(m_samples));
+    m_next = 0;
+    m_count = 0;
+}
+
+TickHistogram::Summary TickHistogram::GetSummary() const
+{
+    Summary summary;
+    if (!m_count)
+        return summary;
+
+    std::vector<uint32> samples(m_samples, m_samples + m_count);
+
+    summary.samples = m_count;
+    summary.last = m_samples[(m_next + TICK_HISTOGRAM_SIZE - 1) % TICK_HISTOGRAM_SIZE];
+
+    std::vector<uint32>::iterator p50 = samples.begin() + (m_count - 1) / 2;
+    std::nth_element(samples.begin(), p50, samples.end());
+    summary.p50 = *p50;
+
+    std::vector<uint32>::iterator p99 = samples.begin() + (m_count - 1) * 99 / 100;
+    std::nth_element(samples.begin(), p99, samples.end());
+    summary.p99 = *p99;
+
+    summary.max = *std::max_element(samples.begin(), samples.end());
+    return summary;
+}
+
+static char const* const tickPhaseNames[MAX_TICK_PHASES] =
+{
+    "total",
+    "auctions",
+    "ahbot",
+    "sessions",
+    "maps",
+    "battlegrounds",
+    "outdoorpvp",
+    "sql callbacks",
+    "game events",
+    "remove list",
+    "cli commands",
+    "terrain",
+};
+
+static std::string FormatSummary(char const* name, TickHistogram::Summary const& summary)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%-28s samples %4u  last %8.2f  p50 %8.2f  p99 %8.2f  max %8.2f", name, summary.samples,
+             summary.last / 1000.0f, summary.p50 / 1000.0f, summary.p99 / 1000.0f, summary.max / 1000.0f);
+    return buf;
+}
+
+void TickProfiler::Reset()
+{
+    for (int i = 0; i < MAX_TICK_PHASES; ++i)
+        m_phases[i].Reset();
+
+    sMapMgr.DoForAllMaps([](Map* map) { map->ResetUpdateStatistics(); });
+}
+
+void TickProfiler::BuildReport(std::vector<std::string>& lines, uint32 maxMaps) const
+{
+    lines.push_back("World update phases (ms):");
+    for (int i = 0; i < MAX_TICK_PHASES; ++i)
+        lines.push_back(FormatSummary(tickPhaseNames[i], m_phases[i].GetSummary()));
+
+    typedef std::pair<Map const*, TickHistogram::Summary> MapSummary;
+    std::vector<MapSummary> mapSummaries;
+    sMapMgr.DoForAllMaps([&mapSummaries](Map* map)
+    {
+        mapSummaries.push_back(MapSummary(map, map->GetUpdateStatistics().histogram.GetSummary()));
+    });
+
+    std::sort(mapSummaries.begin(), mapSummaries.end(), [](MapSummary const& left, MapSummary const& right)
+    {
+        return left.second.p99 > right.second.p99;
+    });
+
+    uint32 shown = maxMaps && maxMaps < mapSummaries.size() ? maxMaps : uint32(mapSummaries.size());
+    char buf[256];
+    snprintf(buf, sizeof(buf), "Map updates (ms), %u of %u maps by p99:", shown, uint32(mapSummaries.size()));
+    lines.push_back(buf);
+
+    for (uint32 i = 0; i < shown; ++i)
+    {
+        Map const* map = mapSummaries[i].first;
+        snprintf(buf, sizeof(buf), "%u:%u %s", map->GetId(), map->GetInstanceId(), map->GetMapName());
+        lines.push_back(FormatSummary(buf, mapSummaries[i].second));
+    }
+
+    lines.push_back("Character DB async queues:");
+    for (uint32 i = 0; i < CharacterDatabase.GetAsyncShardCount(); ++i)
+    {
+        SqlDelayThread const* shard = CharacterDatabase.GetAsyncShard(i);
+        snprintf(buf, sizeof(buf), "shard %u  queued %u  latency last %u ms max %u ms  executed " UI64FMTD,
+                 shard->GetShardIndex(), shard->GetQueueSize(), shard->GetLastLatency(), shard->GetMaxLatency(), shard->GetExecutedCount());
+        lines.push_back(buf);
+    }
+
+    snprintf(buf, sizeof(buf), "Values update blocks: built " UI64FMTD " reused " UI64FMTD,
+             ValuesUpdateBlockCache::GetBuiltCount(), ValuesUpdateBlockCache::GetReusedCount());
+    lines.push_back(buf);
+
+    uint32 saves, statements, rewriteStatements;
+    sWorld.GetPlayerSaveStatistics(saves, statements, rewriteStatements);
+    snprintf(buf, sizeof(buf), "Player saves last autosave interval: %u saves, %u statements instead of %u",
+             saves, statements, rewriteStatements);
+    lines.push_back(buf);
+}
+
+bool TickProfiler::DumpToFile(std::string const& filename) const
+{
+    std::string path = sLog.GetLogsDir() + filename;
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file)
+    {
+        sLog.outError("TickProfiler: can't create dump file %s", path.c_str());
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    BuildReport(lines, 0);
+
+    file << "Tick profile " << Log::GetTimestampStr() << "\n";
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        file << *itr << "\n";
+
+    return file.good();
+}
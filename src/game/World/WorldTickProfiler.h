@@ -0,0 +1,125 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLD_TICK_PROFILER_H
+#define MANGOS_WORLD_TICK_PROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <chrono>
+
+#define TICK_HISTOGRAM_SIZE 1024                            // amount of recent samples kept per histogram
+
+typedef std::chrono::steady_clock TickClock;
+
+inline uint32 GetTickDurationUs(TickClock::time_point startTime)
+{
+    return uint32(std::chrono::duration_cast<std::chrono::microseconds>(TickClock::now() - startTime).count());
+}
+
+// Rolling window of the last TICK_HISTOGRAM_SIZE durations of one measured phase, in microseconds
+// Written by the thread running the phase and read by the world thread between updates
+class TickHistogram
+{
+    public:
+        struct Summary
+        {
+            Summary() : samples(0), last(0), p50(0), p99(0), max(0) {}
+
+            uint32 samples;                                 // samples in window
+            uint32 last;
+            uint32 p50;
+            uint32 p99;
+            uint32 max;                                     // highest sample in window
+        };
+
+        TickHistogram() { Reset(); }
+
+        void Add(uint32 time)
+        {
+            m_samples[m_next] = time;
+            m_next = (m_next + 1) % TICK_HISTOGRAM_SIZE;
+            if (m_count < TICK_HISTOGRAM_SIZE)
+                ++m_count;
+        }
+
+        void Reset();
+        Summary GetSummary() const;
+
+    private:
+        uint32 m_samples[TICK_HISTOGRAM_SIZE];
+        uint32 m_next;
+        uint32 m_count;
+};
+
+// Measures the lifetime of the scope into a histogram
+class TickScopedTimer
+{
+    public:
+        explicit TickScopedTimer(TickHistogram& histogram) : m_histogram(histogram), m_startTime(TickClock::now()) {}
+        ~TickScopedTimer() { m_histogram.Add(GetTickDurationUs(m_startTime)); }
+
+    private:
+        TickHistogram& m_histogram;
+        TickClock::time_point m_startTime;
+};
+
+// World::Update phases measured by the tick profiler
+enum TickPhase
+{
+    TICK_PHASE_TOTAL            = 0,                        // whole World::Update
+    TICK_PHASE_AUCTIONS         = 1,                        // expired auctions and mails
+    TICK_PHASE_AHBOT            = 2,
+    TICK_PHASE_SESSIONS         = 3,
+    TICK_PHASE_MAPS             = 4,
+    TICK_PHASE_BATTLEGROUNDS    = 5,
+    TICK_PHASE_OUTDOORPVP       = 6,
+    TICK_PHASE_SQL_CALLBACKS    = 7,
+    TICK_PHASE_GAME_EVENTS      = 8,
+    TICK_PHASE_REMOVE_LIST      = 9,                        // delayed moves and object removal
+    TICK_PHASE_CLI_COMMANDS     = 10,
+    TICK_PHASE_TERRAIN          = 11,                       // grid map and vmap cleanup
+    MAX_TICK_PHASES
+};
+
+#define TICK_PROFILE_PHASE(phase) TickScopedTimer tickTimer##phase(sTickProfiler.GetPhase(phase))
+
+class TickProfiler
+{
+    public:
+        TickProfiler() {}
+
+        TickHistogram& GetPhase(TickPhase phase) { return m_phases[phase]; }
+
+        // Clears world phase and map histograms
+        void Reset();
+
+        // Human readable report, at most maxMaps maps (sorted by p99) are listed, 0 for all
+        void BuildReport(std::vector<std::string>& lines, uint32 maxMaps) const;
+
+        // Writes the full report into LogsDir, returns false if the file can't be created
+        bool DumpToFile(std::string const& filename) const;
+
+    private:
+        TickHistogram m_phases[MAX_TICK_PHASES];
+};
+
+#define sTickProfiler MaNGOS::Singleton<TickProfiler>::Instance()
+
+#endif
@@ -23,6 +23,9 @@
 
 #include <G3D/Vector3.h>
 
+#include <boost/thread/shared_mutex.hpp>
+
+#include <mutex>
 #include <unordered_map>
 
 //===========================================================
@@ -69,6 +72,11 @@ namespace VMAP
             ModelFileMap iLoadedModelFiles;
             InstanceTreeMap iInstanceMapTrees;
 
+            // maps may update in parallel: tile loading takes the tree lock exclusively, queries take it shared
+            mutable boost::shared_mutex iTreeLock;
+            // models are also acquired and released by gameobjects outside of tile loading
+            std::mutex iModelLock;
+
             bool _loadMap(uint32 pMapId, const std::string& basePath, uint32 tileX, uint32 tileY);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
 
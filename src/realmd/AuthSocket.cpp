@@ -179,7 +179,7 @@ typedef struct AuthHandler
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler)
-    : Socket(service, closeHandler), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER)
+    : Socket(service, closeHandler), _status(STATUS_CHALLENGE), _build(0), _accountId(0), _accountSecurityLevel(SEC_PLAYER)
 {
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
@@ -249,6 +249,21 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
+/// Login database query callback, called from the realmd main loop
+void AuthSocket::QueryCallback(QueryResult* result, AuthSocketPtr socket, QueryResultHandler handler)
+{
+    std::shared_ptr<QueryResult> holder(result);
+
+    socket->PostToNetworkThread([socket, holder, handler]()
+    {
+        // connection may be dropped while the query was in progress
+        if (socket->IsClosed())
+            return;
+
+        (socket.get()->*handler)(holder.get());
+    });
+}
+
 /// Make the SRP6 calculation from hash in dB
 void AuthSocket::_SetVSFields(const std::string& rI)
 {
@@ -364,8 +379,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -377,163 +390,158 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
-    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
-    pkt << (uint8) 0x00;
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4 - i - 1];
+
+    ///- Get the account details and the ip and account bans in one query, the result is handled in _LogonChallengeResult
+    // No SQL injection (escaped user name, IP address as passed by the socket)
+    // One row is returned also for an unknown account, its account columns are NULL then
+    //                                 0                1     2         3          4          5    6    7
+    const char* challengeQuery = "SELECT a.sha_pass_hash, a.id, a.locked, a.last_ip, a.gmlevel, a.v, a.s, a.token, "
+                                 //       8
+                                 "(SELECT COUNT(*) FROM ip_banned WHERE ip = '%s' AND (unbandate = bandate OR unbandate > UNIX_TIMESTAMP())), "
+                                 //       9
+                                 "(SELECT COUNT(*) FROM account_banned ab WHERE ab.id = a.id AND ab.active = 1 AND (ab.unbandate = ab.bandate OR ab.unbandate > UNIX_TIMESTAMP())) "
+                                 "FROM (SELECT 1) AS d LEFT JOIN account a ON a.username = '%s'";
+
+    if (!LoginDatabase.AsyncPQuery(&AuthSocket::QueryCallback, shared<AuthSocket>(), &AuthSocket::_LogonChallengeResult, challengeQuery, m_address.c_str(), _safelogin.c_str()))
+        return false;
+
+    _status = STATUS_DB_QUERY;
+    return true;
+}
+
+/// Logon Challenge account query result handler
+void AuthSocket::_LogonChallengeResult(QueryResult* result)
+{
+    ///- Session is closed unless overriden
+    _status = STATUS_CLOSED;
+
+    if (!result)
+    {
+        Close();
+        return;
+    }
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT unbandate FROM ip_banned "
-            "WHERE (unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+    Field* fields = result->Fetch();
 
-    std::unique_ptr<QueryResult> account_banned_result(LoginDatabase.PQuery(
-            "SELECT ab.unbandate FROM account_banned ab LEFT JOIN account a ON a.id = ab.id "
-                    "WHERE active = 1 AND a.username = '%s' AND (ab.unbandate = ab.bandate OR ab.unbandate > UNIX_TIMESTAMP())", _safelogin.c_str()));
+    ByteBuffer pkt;
+    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+    pkt << (uint8) 0x00;
 
-    if (ip_banned_result || account_banned_result)
+    ///- Verify that this IP and the account are not banned
+    if (fields[8].GetUInt32() || fields[9].GetUInt32())
     {
         pkt << (uint8)WOW_FAIL_BANNED;
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
     }
+    else if (fields[1].IsNULL())                            // no account
+        pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
     else
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
+        ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+        bool locked = false;
+        if (fields[2].GetUInt8() == 1)                      // if ip is locked
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[3].GetString());
+            DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
+            if (strcmp(fields[3].GetString(), m_address.c_str()))
+            {
+                DEBUG_LOG("[AuthChallenge] Account IP differs");
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+                locked = true;
+            }
+            else
+            {
+                DEBUG_LOG("[AuthChallenge] Account IP matches");
+            }
+        }
+        else
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+        }
 
-        QueryResult* result = LoginDatabase.PQuery("SELECT sha_pass_hash,id,locked,last_ip,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        if (!locked)
         {
-            Field* fields = result->Fetch();
+            ///- Get the password from the account table, upper it, and make the SRP6 calculation
+            std::string rI = fields[0].GetCppString();
+
+            ///- Don't calculate (v, s) if there are already some in the database
+            std::string databaseV = fields[5].GetCppString();
+            std::string databaseS = fields[6].GetCppString();
+
+            DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
 
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if (fields[2].GetUInt8() == 1)               // if ip is locked
+            // multiply with 2, bytes are stored as hexstring
+            if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
+                _SetVSFields(rI);
+            else
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[3].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
-                if (strcmp(fields[3].GetString(), m_address.c_str()))
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_SUSPENDED;
-                    locked = true;
-                }
-                else
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
-                }
+                s.SetHexStr(databaseS.c_str());
+                v.SetHexStr(databaseV.c_str());
             }
-            else
+
+            b.SetRand(19 * 8);
+            BigNumber gmod = g.ModExp(b, N);
+            B = ((v * 3) + gmod) % N;
+
+            MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
+
+            BigNumber unk3;
+            unk3.SetRand(16 * 8);
+
+            ///- Fill the response packet with the result
+            pkt << uint8(WOW_SUCCESS);
+
+            // B may be calculated < 32B so we force minimal length to 32B
+            pkt.append(B.AsByteArray(32), 32);              // 32 bytes
+            pkt << uint8(1);
+            pkt.append(g.AsByteArray(), 1);
+            pkt << uint8(32);
+            pkt.append(N.AsByteArray(32), 32);
+            pkt.append(s.AsByteArray(), s.GetNumBytes());   // 32 bytes
+            pkt.append(unk3.AsByteArray(16), 16);
+            uint8 securityFlags = 0;
+
+            _token = fields[7].GetCppString();
+            if (!_token.empty() && _build >= 8606)          // authenticator was added in 2.4.3
+                securityFlags = SECURITY_FLAG_AUTHENTICATOR;
+
+            pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+
+            if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+                pkt << uint32(0);
+                pkt << uint64(0);
+                pkt << uint64(0);
             }
 
-            if (!locked)
+            if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
             {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
-                                         "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", fields[1].GetUInt32());
-                if (banresult)
-                {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
-                    }
-
-                    delete banresult;
-                }
-                else
-                {
-                    ///- Get the password from the account table, upper it, and make the SRP6 calculation
-                    std::string rI = fields[0].GetCppString();
-
-                    ///- Don't calculate (v, s) if there are already some in the database
-                    std::string databaseV = fields[5].GetCppString();
-                    std::string databaseS = fields[6].GetCppString();
-
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
-
-                    // multiply with 2, bytes are stored as hexstring
-                    if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
-                        _SetVSFields(rI);
-                    else
-                    {
-                        s.SetHexStr(databaseS.c_str());
-                        v.SetHexStr(databaseV.c_str());
-                    }
-
-                    b.SetRand(19 * 8);
-                    BigNumber gmod = g.ModExp(b, N);
-                    B = ((v * 3) + gmod) % N;
-
-                    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
-
-                    BigNumber unk3;
-                    unk3.SetRand(16 * 8);
-
-                    ///- Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
-
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(B.AsByteArray(32), 32);      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(g.AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(N.AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(unk3.AsByteArray(16), 16);
-                    uint8 securityFlags = 0;
-
-                    _token = fields[7].GetCppString();
-                    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
-                        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
-
-                    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
-
-                    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
-                        pkt << uint8(1);
-
-                    uint8 secLevel = fields[4].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
-
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4 - i - 1];
-
-                    BASIC_LOG("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
-
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
-                }
+                pkt << uint8(0);
+                pkt << uint8(0);
+                pkt << uint8(0);
+                pkt << uint8(0);
+                pkt << uint64(0);
             }
-            delete result;
+
+            if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
+                pkt << uint8(1);
+
+            _accountId = fields[1].GetUInt32();
+
+            uint8 secLevel = fields[4].GetUInt8();
+            _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+
+            BASIC_LOG("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str(), _localizationName.c_str(), GetLocaleByName(_localizationName));
+
+            ///- All good, await client's proof
+            _status = STATUS_LOGON_PROOF;
         }
-        else                                                // no account
-            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
     }
 
     Write((const char *)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Logon Proof command handler
@@ -702,41 +710,47 @@ bool AuthSocket::_HandleLogonProof()
             // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
             LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
 
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
-            {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
-
-                if (failed_logins >= MaxWrongPassCount)
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
-                }
-                delete loginfail;
-            }
+            LoginDatabase.AsyncPQuery(&AuthSocket::LogonFailedCallback, _login, m_address, "SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str());
         }
     }
     return true;
 }
 
+/// Failed logins query result handler, temporarily bans the account or IP when the limit is reached
+void AuthSocket::LogonFailedCallback(QueryResult* result, std::string login, std::string address)
+{
+    if (!result)
+        return;
+
+    Field* fields = result->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+    uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+
+    if (failed_logins >= MaxWrongPassCount)
+    {
+        uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+        bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+
+        if (WrongPassBanType)
+        {
+            uint32 acc_id = fields[0].GetUInt32();
+            LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                   acc_id, WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                      login.c_str(), WrongPassBanTime, failed_logins);
+        }
+        else
+        {
+            LoginDatabase.escape_string(address);
+            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                   address.c_str(), WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                      address.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+        }
+    }
+    delete result;
+}
+
 /// Reconnect Challenge command handler
 bool AuthSocket::_HandleReconnectChallenge()
 {
@@ -780,19 +794,32 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    ///- Get the session key, the result is handled in _ReconnectChallengeResult
+    if (!LoginDatabase.AsyncPQuery(&AuthSocket::QueryCallback, shared<AuthSocket>(), &AuthSocket::_ReconnectChallengeResult,
+                                   "SELECT sessionkey, id FROM account WHERE username = '%s'", _safelogin.c_str()))
+        return false;
+
+    _status = STATUS_DB_QUERY;
+    return true;
+}
+
+/// Reconnect Challenge session key query result handler
+void AuthSocket::_ReconnectChallengeResult(QueryResult* result)
+{
+    ///- Session is closed unless overriden
+    _status = STATUS_CLOSED;
 
     // Stop if the account is not found
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
         Close();
-        return false;
+        return;
     }
 
     Field* fields = result->Fetch();
     K.SetHexStr(fields[0].GetString());
-    delete result;
+    _accountId = fields[1].GetUInt32();
 
     ///- All good, await client's proof
     _status = STATUS_RECON_PROOF;
@@ -805,7 +832,6 @@ bool AuthSocket::_HandleReconnectChallenge()
     pkt.append(_reconnectProof.AsByteArray(16), 16);        // 16 bytes random
     pkt << (uint64) 0x00 << (uint64) 0x00;                  // 16 bytes zeros
     Write((const char *)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Reconnect Proof command handler
@@ -863,39 +889,66 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
+    ///- Get the number of characters of the account on each realm, the result is handled in _RealmListResult
+    if (!LoginDatabase.AsyncPQuery(&AuthSocket::QueryCallback, shared<AuthSocket>(), &AuthSocket::_RealmListResult,
+                                   "SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", _accountId))
+        return false;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT id,sha_pass_hash FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    _status = STATUS_DB_QUERY;
+    return true;
+}
+
+/// Realm List characters query result handler
+void AuthSocket::_RealmListResult(QueryResult* result)
+{
+    std::map<uint32, uint8> charCounts;
+    if (result)
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
+        do
+        {
+            Field* fields = result->Fetch();
+            charCounts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
-    delete result;
-
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
 
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+    ///- Realm part of the packet only depends on client build and account security level, build it once per realm list update
+    RealmListPacketPtr realms = sRealmList.GetCachedPacket(_build, _accountSecurityLevel);
+    if (!realms)
+    {
+        std::shared_ptr<RealmListPacket> packet = std::make_shared<RealmListPacket>();
+        LoadRealmlist(*packet);
+        sRealmList.CachePacket(_build, _accountSecurityLevel, packet);
+        realms = packet;
+    }
+
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    pkt << (uint8) CMD_REALM_LIST;
+    pkt << (uint16)realms->body.size();
 
-    ByteBuffer hdr;
-    hdr << (uint8) CMD_REALM_LIST;
-    hdr << (uint16)pkt.size();
-    hdr.append(pkt);
+    size_t const bodyPos = pkt.wpos();
+    pkt.append(realms->body);
 
-    Write((const char *)hdr.contents(), hdr.size());
-    return true;
+    ///- Fill in the number of user characters in each realm
+    for (std::vector<std::pair<uint32, size_t> >::const_iterator itr = realms->charCountPos.begin(); itr != realms->charCountPos.end(); ++itr)
+    {
+        std::map<uint32, uint8>::const_iterator count = charCounts.find(itr->first);
+        if (count != charCounts.end())
+            pkt.put<uint8>(bodyPos + itr->second, count->second);
+    }
+
+    _status = STATUS_AUTHED;
+
+    Write((const char *)pkt.contents(), pkt.size());
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
+void AuthSocket::LoadRealmlist(RealmListPacket& packet)
 {
+    ByteBuffer& pkt = packet.body;
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -907,19 +960,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
@@ -946,7 +986,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
                 pkt << name;                                // name
                 pkt << i->second.address;                   // address
                 pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                packet.charCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // number of characters, filled per account
                 pkt << uint8(i->second.timezone);           // realm category
                 pkt << uint8(0x00);                         // unk, may be realm number/id?
             }
@@ -968,19 +1009,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 
             for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
@@ -1004,7 +1032,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
                 pkt << i->first;                            // name
                 pkt << i->second.address;                   // address
                 pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                packet.charCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // number of characters, filled per account
                 pkt << uint8(i->second.timezone);           // realm category (Cfg_Categories.dbc)
                 pkt << uint8(0x2C);                         // unk, may be realm number/id?
 
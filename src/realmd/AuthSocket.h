@@ -27,6 +27,7 @@
 #include "Auth/BigNumber.h"
 #include "Auth/Sha1.h"
 #include "ByteBuffer.h"
+#include "RealmList.h"
 
 #include "Network/Socket.hpp"
 
@@ -36,6 +37,8 @@
 
 #define HMAC_RES_SIZE 20
 
+class QueryResult;
+
 class AuthSocket : public MaNGOS::Socket
 {
     public:
@@ -44,7 +47,7 @@ class AuthSocket : public MaNGOS::Socket
         AuthSocket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
 
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
+        void LoadRealmlist(RealmListPacket& packet);
         int32 generateToken(char const* b32key);
 
         bool _HandleLogonChallenge();
@@ -68,9 +71,22 @@ class AuthSocket : public MaNGOS::Socket
             STATUS_RECON_PROOF,
             STATUS_PATCH,      // unused in CMaNGOS
             STATUS_AUTHED,
+            STATUS_DB_QUERY,   // waiting for a login database query, no packets accepted
             STATUS_CLOSED
         };
 
+        typedef std::shared_ptr<AuthSocket> AuthSocketPtr;
+        typedef void (AuthSocket::*QueryResultHandler)(QueryResult*);
+
+        // login database queries are executed async, the result callback is called from the realmd main loop
+        // and passes the result to the handler in the network thread of the socket
+        static void QueryCallback(QueryResult* result, AuthSocketPtr socket, QueryResultHandler handler);
+        static void LogonFailedCallback(QueryResult* result, std::string login, std::string address);
+
+        void _LogonChallengeResult(QueryResult* result);
+        void _ReconnectChallengeResult(QueryResult* result);
+        void _RealmListResult(QueryResult* result);
+
         BigNumber N, s, g, v;
         BigNumber b, B;
         BigNumber K;
@@ -86,6 +102,7 @@ class AuthSocket : public MaNGOS::Socket
         // between enUS and enGB, which is important for the patch system
         std::string _localizationName;
         uint16 _build;
+        uint32 _accountId;
         AccountTypes _accountSecurityLevel;
 
         virtual bool ProcessIncomingData() override;
@@ -277,8 +277,11 @@ int main(int argc, char *argv[])
     // server has started up successfully => enable async DB requests
     LoginDatabase.AllowAsyncTransactions();
 
+    // sleep between loops, also the upper bound of the delay added to async login queries
+    uint32 const loopDelay = 10;
+
     // maximum counter for next ping
-    auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * 10;
+    auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * IN_MILLISECONDS / loopDelay;
     uint32 loopCounter = 0;
 
 #ifndef _WIN32
@@ -293,7 +296,11 @@ int main(int argc, char *argv[])
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        ///- Pass completed login queries back to their sockets
+        LoginDatabase.ProcessResultQueue();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(loopDelay));
 #ifdef _WIN32
         if (m_ServiceStatus == 0) stopEvent = true;
         while (m_ServiceStatus == 2) Sleep(1000);
@@ -133,11 +133,23 @@ void RealmList::UpdateIfNeed()
 
     // Clears Realm list
     m_realms.clear();
+    m_packetCache.clear();
 
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
 }
 
+RealmListPacketPtr RealmList::GetCachedPacket(uint16 build, AccountTypes security) const
+{
+    PacketCache::const_iterator itr = m_packetCache.find((uint32(build) << 8) | uint32(security));
+    return itr != m_packetCache.end() ? itr->second : RealmListPacketPtr();
+}
+
+void RealmList::CachePacket(uint16 build, AccountTypes security, RealmListPacketPtr const& packet)
+{
+    m_packetCache[(uint32(build) << 8) | uint32(security)] = packet;
+}
+
 void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
@@ -24,6 +24,9 @@
 #define _REALMLIST_H
 
 #include "Common.h"
+#include "ByteBuffer.h"
+
+#include <memory>
 
 struct RealmBuildInfo
 {
@@ -52,6 +55,16 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+/// Realm list packet body prepared for one client build and account security level
+/// Character counts are account specific, they are written as zero and patched in for every request
+struct RealmListPacket
+{
+    ByteBuffer body;
+    std::vector<std::pair<uint32, size_t> > charCountPos;   // realm id, position of the realm character count in body
+};
+
+typedef std::shared_ptr<RealmListPacket const> RealmListPacketPtr;
+
 /// Storage object for the list of realms on the server
 class RealmList
 {
@@ -70,11 +83,18 @@ class RealmList
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
+
+        // packet bodies built from the current realm list, dropped at every realm list refresh
+        RealmListPacketPtr GetCachedPacket(uint16 build, AccountTypes security) const;
+        void CachePacket(uint16 build, AccountTypes security, RealmListPacketPtr const& packet);
     private:
         void UpdateRealms(bool init);
         void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
+        typedef std::map<uint32, RealmListPacketPtr> PacketCache;
+
         RealmMap m_realms;                                  ///< Internal map of realms
+        PacketCache m_packetCache;                          ///< Realm list packets by client build and security level
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
 };
@@ -52,6 +52,35 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
     }
 }
 
+void AuthCrypt::EncryptClientSend(uint8* data, size_t len)
+{
+    if (!_initialized) return;
+    if (len < CRYPTED_RECV_LEN) return;
+
+    for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+    {
+        _recv_i %= _key.size();
+        uint8 x = (data[t] ^ _key[_recv_i]) + _recv_j;
+        ++_recv_i;
+        data[t] = _recv_j = x;
+    }
+}
+
+void AuthCrypt::DecryptClientRecv(uint8* data, size_t len)
+{
+    if (!_initialized) return;
+    if (len < CRYPTED_SEND_LEN) return;
+
+    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    {
+        _send_i %= _key.size();
+        uint8 x = (data[t] - _send_j) ^ _key[_send_i];
+        ++_send_i;
+        _send_j = data[t];
+        data[t] = x;
+    }
+}
+
 void AuthCrypt::Init(BigNumber *bn)
 {
     _send_i = _send_j = _recv_i = _recv_j = 0;
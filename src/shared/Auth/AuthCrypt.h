@@ -34,6 +34,10 @@ class AuthCrypt
         void DecryptRecv(uint8*, size_t);
         void EncryptSend(uint8*, size_t);
 
+        // client side counterparts of DecryptRecv and EncryptSend
+        void EncryptClientSend(uint8*, size_t);
+        void DecryptClientRecv(uint8*, size_t);
+
     private:
         const static size_t CRYPTED_SEND_LEN = 4;
         const static size_t CRYPTED_RECV_LEN = 6;
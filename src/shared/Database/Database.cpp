@@ -97,7 +97,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -134,10 +134,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConns.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConns[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -150,10 +165,13 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        delete m_pAsyncConns[i];
 
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
+    m_pAsyncConns.clear();
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
         delete m_pQueryConnections[i];
@@ -161,30 +179,49 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+thread_local Database const* Database::m_asyncShardDb = nullptr;
+thread_local uint32 Database::m_asyncShardKey = 0;
+
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, uint32 shardIndex)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, shardIndex);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay thread for delay execute on each async connection
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+    {
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConns[i], uint32(i)); // will deleted at thread delete
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    // threads stop one after another, a barrier must not wait for a thread which already left
+    m_asyncDraining = true;
+
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Stop();                          // Stop event
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+
+    // requests queued meanwhile are executed when deleting the thread bodies
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+        delete m_delayThreads[i];                           // This also deletes thread body
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+    m_asyncDraining = false;
 }
 
 void Database::ThreadStart()
@@ -229,8 +266,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConns[i]);
         delete guard->Query(sql);
     }
 
@@ -341,7 +379,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        delayAsyncWrite(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -400,6 +438,12 @@ bool Database::BeginTransaction()
     return !!m_currentTransaction.get();
 }
 
+void Database::SetTransactionFailedFlag(std::shared_ptr<std::atomic<bool> > const& failed)
+{
+    if (m_currentTransaction.get())
+        m_currentTransaction->SetFailedFlag(failed);
+}
+
 bool Database::CommitTransaction()
 {
     if (!m_pAsyncConn || !m_currentTransaction.get())
@@ -410,10 +454,25 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    delayAsyncWrite(m_currentTransaction.release());
     return true;
 }
 
+void Database::delayAsyncWrite(SqlOperation* op)
+{
+    if (m_asyncShardDb != this || m_asyncShardKey != ASYNC_SHARD_KEY_ORDERED || m_threadBodies.size() < 2)
+    {
+        getAsyncDelayThread()->Delay(op);
+        return;
+    }
+
+    std::shared_ptr<SqlAsyncBarrier> barrier(new SqlAsyncBarrier(*this, op, uint32(m_threadBodies.size())));
+
+    std::lock_guard<std::mutex> guard(m_asyncBarrierLock);
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Delay(new SqlBarrierRequest(barrier));
+}
+
 bool Database::CommitTransactionDirect()
 {
     if (!m_pAsyncConn)
@@ -565,7 +624,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        delayAsyncWrite(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -613,7 +672,49 @@ SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 std::string Database::GetStmtString(const int stmtId) const
 {
     LOCK_GUARD _guard(m_stmtGuard);
+    return GetStmtStringLocked(stmtId);
+}
+
+int Database::GetMultiRowStmtIndex(int nIndex, uint32 nRows)
+{
+    if (nRows <= 1)
+        return nIndex;
+
+    LOCK_GUARD _guard(m_stmtGuard);
+
+    uint64 const key = (uint64(uint32(nIndex)) << 32) | nRows;
+    auto const itr = m_multiRowStmts.find(key);
+    if (itr != m_multiRowStmts.end())
+        return itr->second;
+
+    int nId = -1;
+
+    std::string const fmt = GetStmtStringLocked(nIndex);
+    size_t valuesBegin, valuesEnd;
+    if (!fmt.empty() && SqlSplitInsertValues(fmt.c_str(), valuesBegin, valuesEnd))
+    {
+        std::string const row = fmt.substr(valuesBegin, valuesEnd - valuesBegin);
+        std::string szFmt = fmt.substr(0, valuesEnd);
+        for (uint32 i = 1; i < nRows; ++i)
+            szFmt.append(", ").append(row);
 
+        PreparedStmtRegistry::const_iterator iter = m_stmtRegistry.find(szFmt);
+        if (iter == m_stmtRegistry.end())
+        {
+            nId = ++m_iStmtIndex;
+            m_stmtRegistry[szFmt] = nId;
+        }
+        else
+            nId = iter->second;
+    }
+
+    // not mergeable statements are remembered too
+    m_multiRowStmts[key] = nId;
+    return nId;
+}
+
+std::string Database::GetStmtStringLocked(const int stmtId) const
+{
     if (stmtId == -1 || stmtId > m_iStmtIndex)
         return std::string();
 
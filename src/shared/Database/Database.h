@@ -104,12 +104,44 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // start worker threads for async DB request execution
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads
         virtual void HaltDelayThread();
 
+        // shard key of AsyncOrderedGuard, not a valid account id
+        static uint32 const ASYNC_SHARD_KEY_ORDERED = 0xFFFFFFFF;
+
+        // async requests issued by the current thread while the guard exists go to the async connection selected by key
+        // requests with the same key (for example of one account) are executed in order, other requests use the first connection
+        class AsyncShardGuard
+        {
+            public:
+                AsyncShardGuard(Database& db, uint32 key) : m_prevDb(m_asyncShardDb), m_prevKey(m_asyncShardKey)
+                {
+                    m_asyncShardDb = &db;
+                    m_asyncShardKey = key;
+                }
+                ~AsyncShardGuard()
+                {
+                    m_asyncShardDb = m_prevDb;
+                    m_asyncShardKey = m_prevKey;
+                }
+
+            private:
+                Database const* m_prevDb;
+                uint32 m_prevKey;
+        };
+
+        // async writes issued by the current thread while the guard exists are ordered with the requests of all async connections
+        // needed for writes touching rows of several characters (mail, trade, auctions), which other keys may change too
+        class AsyncOrderedGuard : public AsyncShardGuard
+        {
+            public:
+                explicit AsyncOrderedGuard(Database& db) : AsyncShardGuard(db, ASYNC_SHARD_KEY_ORDERED) {}
+        };
+
         /// Synchronous DB queries
         inline QueryResult* Query(const char* sql)
         {
@@ -186,6 +218,8 @@ class Database
         bool BeginTransaction();
         bool CommitTransaction();
         bool RollbackTransaction();
+        // flag set from the delay thread if the current transaction fails
+        void SetTransactionFailedFlag(std::shared_ptr<std::atomic<bool> > const& failed);
         // for sync transaction execution
         bool CommitTransactionDirect();
 
@@ -212,6 +246,15 @@ class Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
+        // async connection pool, each connection is served by its own delay thread
+        uint32 GetAsyncShardCount() const { return uint32(m_threadBodies.size()); }
+        SqlDelayThread const* GetAsyncShard(uint32 index) const { return m_threadBodies[index]; }
+        // set while the requests left after stopping the delay threads are executed
+        bool IsAsyncDraining() const { return m_asyncDraining; }
+
+        // index of prepared statement inserting nRows rows at once built from single-row insert nIndex, -1 if not possible
+        int GetMultiRowStmtIndex(int nIndex, uint32 nRows);
+
         // function to ping database connections
         void Ping();
 
@@ -222,8 +265,7 @@ class Database
 
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_bAllowAsyncTransactions(false),
+            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr), m_asyncDraining(false), m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -234,17 +276,28 @@ class Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, uint32 shardIndex);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
+        // key set by AsyncShardGuard on the current thread, valid for m_asyncShardDb only
+        static thread_local Database const* m_asyncShardDb;
+        static thread_local uint32 m_asyncShardKey;
 
         ///< DB connections
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection for direct execution of async requests
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // delay thread for async requests of the current thread
+        SqlDelayThread* getAsyncDelayThread() const
+        {
+            bool sharded = m_asyncShardDb == this && m_asyncShardKey != ASYNC_SHARD_KEY_ORDERED;
+            return m_threadBodies[sharded ? m_asyncShardKey % m_threadBodies.size() : 0];
+        }
+        // queue an async write of the current thread, inside AsyncOrderedGuard as barrier on all delay threads
+        void delayAsyncWrite(SqlOperation* op);
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
@@ -260,12 +313,16 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // pool of connections for transactions and async queries, requests of one key always use the same one
+        SqlConnectionContainer m_pAsyncConns;
+        // first async connection, also used for direct execution
         SqlConnection* m_pAsyncConn;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        std::vector<SqlDelayThread*> m_threadBodies;        ///< Delay sql executers, one per async connection (owned by m_delayThreads)
+        std::vector<MaNGOS::Thread*> m_delayThreads;        ///< Executer threads
+        std::mutex m_asyncBarrierLock;                      ///< keeps the order of barriers the same on all delay threads
+        std::atomic<bool> m_asyncDraining;                  ///< delay threads are stopped, left requests are executed one thread after another
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
@@ -280,6 +337,11 @@ class Database
 
         int m_iStmtIndex;
 
+        // multi-row statements built from single-row inserts, key is statement index and row count
+        std::unordered_map<uint64, int> m_multiRowStmts;
+
+        std::string GetStmtStringLocked(const int stmtId) const;
+
     private:
 
         bool m_logSQL;
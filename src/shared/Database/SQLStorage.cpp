@@ -17,6 +17,77 @@
  */
 
 #include "SQLStorage.h"
+#include "Log.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#define SQL_STORAGE_SNAPSHOT_MAGIC      0x534E5357          // "WSNS"
+#define SQL_STORAGE_SNAPSHOT_VERSION    1
+
+// Snapshot file layout: header, record ids, raw records with zeroed pointer fields,
+// then for every pointer field of every record its string length + 1 (0 for nullptr) and data
+struct SQLStorageSnapshotHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint64 key;
+    uint32 recordSize;
+    uint32 recordCount;
+    uint32 maxEntry;
+    uint32 pointerSize;
+};
+
+static uint64 HashSnapshotData(uint64 hash, void const* data, size_t size)
+{
+    // FNV-1a
+    uint8 const* bytes = static_cast<uint8 const*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= uint64(0x100000001B3ULL);
+    }
+    return hash;
+}
+
+static void GetPointerFieldOffsets(char const* dstFormat, std::vector<uint32>& offsets)
+{
+    uint32 offset = 0;
+    for (char const* fmt = dstFormat; *fmt; ++fmt)
+    {
+        switch (*fmt)
+        {
+            case FT_LOGIC:
+                offset += sizeof(bool);
+                break;
+            case FT_STRING:
+            case FT_NA_POINTER:
+                offsets.push_back(offset);
+                offset += sizeof(char*);
+                break;
+            case FT_NA:
+            case FT_INT:
+                offset += sizeof(uint32);
+                break;
+            case FT_BYTE:
+            case FT_NA_BYTE:
+                offset += sizeof(char);
+                break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:
+                offset += sizeof(float);
+                break;
+            case FT_64BITINT:
+                offset += sizeof(uint64);
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+}
+
+std::string SQLStorageBase::m_snapshotDir;
 
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
@@ -44,6 +115,209 @@ void SQLStorageBase::Initialize(const char* tableName, const char* entry_field,
     m_dstFieldCount = strlen(m_dst_format);
 }
 
+void SQLStorageBase::SetSnapshotDir(std::string const& dir)
+{
+    m_snapshotDir = dir;
+
+    // normalize dir path to path/ or path\ form
+    if (!m_snapshotDir.empty() && m_snapshotDir.at(m_snapshotDir.length() - 1) != '/' && m_snapshotDir.at(m_snapshotDir.length() - 1) != '\\')
+        m_snapshotDir.append("/");
+}
+
+std::string SQLStorageBase::GetSnapshotFileName() const
+{
+    return m_snapshotDir + m_tableName + ".snapshot";
+}
+
+uint64 SQLStorageBase::CalculateSnapshotKey(uint64 loaderKey) const
+{
+#ifndef DO_POSTGRESQL
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", m_tableName);
+    if (!result)
+        return 0;
+
+    Field* fields = result->Fetch();
+    if (fields[1].IsNULL())
+    {
+        delete result;
+        return 0;
+    }
+
+    uint64 checksum = fields[1].GetUInt64();
+    delete result;
+
+    uint64 key = uint64(0xCBF29CE484222325ULL);
+    key = HashSnapshotData(key, &checksum, sizeof(checksum));
+    key = HashSnapshotData(key, m_src_format, m_srcFieldCount);
+    key = HashSnapshotData(key, m_dst_format, m_dstFieldCount);
+    key = HashSnapshotData(key, &loaderKey, sizeof(loaderKey));
+    return key ? key : 1;
+#else
+    // no cheap content checksum available
+    return 0;
+#endif
+}
+
+bool SQLStorageBase::LoadSnapshot(uint64 key, uint32 recordSize)
+{
+    std::string filename = GetSnapshotFileName();
+
+    boost::interprocess::mapped_region* region = nullptr;
+    try
+    {
+        boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+        region = new boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        return false;                                       // no snapshot yet
+    }
+
+    char const* data = static_cast<char const*>(region->get_address());
+    size_t size = region->get_size();
+
+    SQLStorageSnapshotHeader header;
+    if (size < sizeof(header))
+    {
+        delete region;
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    size_t recordsPos = sizeof(header) + size_t(header.recordCount) * sizeof(uint32);
+    size_t stringsPos = recordsPos + size_t(header.recordCount) * header.recordSize;
+    if (header.magic != SQL_STORAGE_SNAPSHOT_MAGIC || header.version != SQL_STORAGE_SNAPSHOT_VERSION ||
+            header.key != key || header.recordSize != recordSize || header.pointerSize != sizeof(char*) ||
+            header.recordCount == 0 || stringsPos > size)
+    {
+        delete region;
+        DETAIL_LOG("Snapshot of %s table is outdated, loading from database", m_tableName);
+        return false;
+    }
+
+    std::vector<uint32> pointerOffsets;
+    GetPointerFieldOffsets(m_dst_format, pointerOffsets);
+
+    // validate the whole file before touching the current storage content
+    size_t pos = stringsPos;
+    for (uint32 i = 0; i < header.recordCount * pointerOffsets.size(); ++i)
+    {
+        uint32 length;
+        if (pos + sizeof(length) > size)
+            break;
+        memcpy(&length, data + pos, sizeof(length));
+        pos += sizeof(length) + length;
+    }
+
+    if (pos != size)
+    {
+        delete region;
+        sLog.outError("Snapshot file %s is corrupted, loading %s table from database", filename.c_str(), m_tableName);
+        return false;
+    }
+
+    prepareToLoad(header.maxEntry, header.recordCount, recordSize);
+
+    pos = stringsPos;
+    for (uint32 i = 0; i < header.recordCount; ++i)
+    {
+        uint32 recordId;
+        memcpy(&recordId, data + sizeof(header) + i * sizeof(uint32), sizeof(recordId));
+
+        char* record = createRecord(recordId);
+        memcpy(record, data + recordsPos + size_t(i) * recordSize, recordSize);
+
+        for (uint32 offset : pointerOffsets)
+        {
+            uint32 length;
+            memcpy(&length, data + pos, sizeof(length));
+            pos += sizeof(length);
+
+            char* str = nullptr;
+            if (length)
+            {
+                str = new char[length];
+                memcpy(str, data + pos, length);
+                pos += length;
+            }
+            memcpy(record + offset, &str, sizeof(str));
+        }
+    }
+
+    delete region;
+
+    sLog.outString(">> Loaded %u records of %s table from snapshot", header.recordCount, m_tableName);
+    return true;
+}
+
+void SQLStorageBase::SaveSnapshot(uint64 key, std::vector<uint32> const& recordIds) const
+{
+    if (recordIds.size() != m_recordCount || !m_recordCount)
+        return;
+
+    std::string filename = GetSnapshotFileName();
+    std::string tmpFilename = filename + ".tmp";
+
+    FILE* file = fopen(tmpFilename.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Can't create snapshot file %s", tmpFilename.c_str());
+        return;
+    }
+
+    SQLStorageSnapshotHeader header;
+    header.magic = SQL_STORAGE_SNAPSHOT_MAGIC;
+    header.version = SQL_STORAGE_SNAPSHOT_VERSION;
+    header.key = key;
+    header.recordSize = m_recordSize;
+    header.recordCount = m_recordCount;
+    header.maxEntry = m_maxEntry;
+    header.pointerSize = sizeof(char*);
+
+    std::vector<uint32> pointerOffsets;
+    GetPointerFieldOffsets(m_dst_format, pointerOffsets);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(&recordIds[0], sizeof(uint32), recordIds.size(), file) == recordIds.size();
+
+    // pointers are meaningless in the next process, store them zeroed
+    std::vector<char> record(m_recordSize);
+    for (uint32 i = 0; ok && i < m_recordCount; ++i)
+    {
+        memcpy(&record[0], m_data + i * m_recordSize, m_recordSize);
+        for (uint32 offset : pointerOffsets)
+            memset(&record[offset], 0, sizeof(char*));
+        ok = fwrite(&record[0], m_recordSize, 1, file) == 1;
+    }
+
+    for (uint32 i = 0; ok && i < m_recordCount; ++i)
+    {
+        for (uint32 offset : pointerOffsets)
+        {
+            char const* str;
+            memcpy(&str, m_data + i * m_recordSize + offset, sizeof(str));
+
+            uint32 length = str ? strlen(str) + 1 : 0;
+            ok = ok && fwrite(&length, sizeof(length), 1, file) == 1;
+            ok = ok && (!length || fwrite(str, length, 1, file) == 1);
+        }
+    }
+
+    ok = fclose(file) == 0 && ok;
+
+#if PLATFORM == PLATFORM_WINDOWS
+    if (ok)
+        remove(filename.c_str());                           // rename doesn't replace existing files here
+#endif
+
+    // rename only complete files, so a crash while writing leaves the old snapshot usable
+    if (!ok || rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        remove(tmpFilename.c_str());
+        sLog.outError("Can't write snapshot file %s", filename.c_str());
+    }
+}
+
 char* SQLStorageBase::createRecord(uint32 recordId)
 {
     char* newRecord = &m_data[m_recordCount * m_recordSize];
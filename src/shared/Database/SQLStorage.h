@@ -23,6 +23,8 @@
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
 
+#include <vector>
+
 class SQLStorageBase
 {
         template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
@@ -64,6 +66,10 @@ class SQLStorageBase
         template<typename T>
         SQLSIterator<T> getDataEnd() const { return SQLSIterator<T>(m_data + m_recordCount * m_recordSize, m_recordSize); }
 
+        // Directory for binary table snapshots, empty string disables them
+        static void SetSnapshotDir(std::string const& dir);
+        static bool IsSnapshotEnabled() { return !m_snapshotDir.empty(); }
+
     protected:
         SQLStorageBase();
         virtual ~SQLStorageBase() { Free(); }
@@ -81,6 +87,14 @@ class SQLStorageBase
     private:
         char* createRecord(uint32 recordId);
 
+        // Snapshot support, key is 0 when the table content can't be hashed
+        uint64 CalculateSnapshotKey(uint64 loaderKey) const;
+        std::string GetSnapshotFileName() const;
+        bool LoadSnapshot(uint64 key, uint32 recordSize);
+        void SaveSnapshot(uint64 key, std::vector<uint32> const& recordIds) const;
+
+        static std::string m_snapshotDir;
+
         // Information about the table
         const char* m_tableName;
         const char* m_entry_field;
@@ -269,6 +283,9 @@ class SQLStorageLoaderBase
         void convert_from_str(uint32 field_pos, char* src, D& dst);
         void convert_str_to_str(uint32 field_pos, char* src, char*& dst);
 
+        // Loaders converting fields with external data must hash that data here to invalidate snapshots
+        uint64 GetSnapshotKey() const { return 0; }
+
     private:
         template<class V>
         void storeValue(V value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
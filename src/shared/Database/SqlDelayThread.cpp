@@ -20,7 +20,9 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, uint32 shardIndex) :
+    m_dbEngine(db), m_dbConnection(conn), m_shardIndex(shardIndex), m_running(true),
+    m_queueSize(0), m_lastLatency(0), m_maxLatency(0), m_executedCount(0)
 {
 }
 
@@ -52,10 +54,15 @@ void SqlDelayThread::run()
         if ((loopCounter++) >= pingEveryLoop)
         {
             loopCounter = 0;
-            m_dbEngine->Ping();
+            // first thread of the pool keeps all connections of the database alive
+            if (m_shardIndex == 0)
+                m_dbEngine->Ping();
         }
     }
 
+    // requests queued after the last loop, barriers of other threads may wait for them
+    ProcessRequests();
+
 #ifndef DO_POSTGRESQL
     mysql_thread_end();
 #endif
@@ -68,19 +75,36 @@ void SqlDelayThread::Stop()
 
 void SqlDelayThread::ProcessRequests()
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    std::vector<QueuedOperation> sqlQueue;
 
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
     {
         std::lock_guard<std::mutex> guard(m_queueMutex);
-        sqlQueue = std::move(m_sqlQueue);
+        sqlQueue.swap(m_sqlQueue);
+        m_queueSize = 0;
     }
 
-    while (!sqlQueue.empty())
+    if (sqlQueue.empty())
+        return;
+
+    uint32 const now = WorldTimer::getMSTime();
+    uint32 latency = 0;
+
+    std::vector<SqlOperation*> operations;
+    operations.reserve(sqlQueue.size());
+    for (auto& queued : sqlQueue)
     {
-        auto const s = std::move(sqlQueue.front());
-        sqlQueue.pop();
-        s->Execute(m_dbConnection);
+        latency = std::max(latency, WorldTimer::getMSTimeDiff(queued.queueTime, now));
+        operations.push_back(queued.operation.get());
     }
+
+    m_lastLatency = latency;
+    if (latency > m_maxLatency)
+        m_maxLatency = latency;
+
+    // adjacent single-row inserts into the same table are sent as one statement, errors do not stop the batch
+    SqlExecuteBatch(m_dbConnection, &operations[0], operations.size(), false);
+
+    m_executedCount += operations.size();
 }
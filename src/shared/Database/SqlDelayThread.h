@@ -21,10 +21,12 @@
 
 #include "Threading.h"
 #include "SqlOperations.h"
+#include "Timer.h"
 
 #include <mutex>
-#include <queue>
+#include <vector>
 #include <memory>
+#include <atomic>
 
 class Database;
 class SqlOperation;
@@ -33,27 +35,53 @@ class SqlConnection;
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
+        struct QueuedOperation
+        {
+            QueuedOperation(SqlOperation* op, uint32 time) : operation(op), queueTime(time) {}
+
+            std::unique_ptr<SqlOperation> operation;
+            uint32 queueTime;                               ///< time of the Delay() call, used for latency statistics
+        };
+
         std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        std::vector<QueuedOperation> m_sqlQueue;                ///< Queue of SQL statements
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
+        uint32 m_shardIndex;                                    ///< Index of this thread in the database async pool
         volatile bool m_running;
 
+        // statistics, written by the delay thread and read from any thread
+        std::atomic<uint32> m_queueSize;
+        std::atomic<uint32> m_lastLatency;
+        std::atomic<uint32> m_maxLatency;
+        std::atomic<uint64> m_executedCount;
+
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, uint32 shardIndex = 0);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            m_sqlQueue.emplace_back(sql, WorldTimer::getMSTime());
+            m_queueSize = uint32(m_sqlQueue.size());
             return true;
         }
 
+        uint32 GetShardIndex() const { return m_shardIndex; }
+        // amount of requests waiting for execution
+        uint32 GetQueueSize() const { return m_queueSize; }
+        // highest time in ms a request waited in the queue during the last processed batch
+        uint32 GetLastLatency() const { return m_lastLatency; }
+        // highest time in ms a request waited in the queue since start
+        uint32 GetMaxLatency() const { return m_maxLatency; }
+        // amount of requests executed since start
+        uint64 GetExecutedCount() const { return m_executedCount; }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
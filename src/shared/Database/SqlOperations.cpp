@@ -22,11 +22,116 @@
 #include "DatabaseImpl.h"
 
 #include <cstdarg>
+#include <chrono>
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
 
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
+bool SqlSplitInsertValues(const char* sql, size_t& valuesBegin, size_t& valuesEnd)
+{
+    if (strncmp(sql, "INSERT INTO ", 12) != 0 && strncmp(sql, "REPLACE INTO ", 13) != 0)
+        return false;
+
+    const char* values = strstr(sql, " VALUES");
+    if (!values)
+        return false;
+
+    // a quote before the keyword means it may be part of a literal
+    for (const char* c = sql; c != values; ++c)
+        if (*c == '\'' || *c == '"')
+            return false;
+
+    const char* c = values + 7;
+    while (isspace(*c))
+        ++c;
+
+    if (*c != '(')
+        return false;
+
+    valuesBegin = c - sql;
+
+    for (;;)
+    {
+        // skip one row, brackets and quotes inside of literals are ignored
+        int depth = 0;
+        char quote = 0;
+        for (; *c; ++c)
+        {
+            if (quote)
+            {
+                if (*c == '\\' && c[1])
+                    ++c;
+                else if (*c == quote)
+                    quote = 0;
+            }
+            else if (*c == '\'' || *c == '"')
+                quote = *c;
+            else if (*c == '(')
+                ++depth;
+            else if (*c == ')' && --depth == 0)
+                break;
+        }
+
+        if (!*c)
+            return false;
+
+        valuesEnd = ++c - sql;
+
+        while (isspace(*c))
+            ++c;
+
+        if (*c != ',')
+            break;
+
+        ++c;
+        while (isspace(*c))
+            ++c;
+
+        if (*c != '(')
+            return false;
+    }
+
+    // anything except a closing semicolon (ON DUPLICATE KEY UPDATE etc.) prevents adding rows
+    if (*c == ';')
+        ++c;
+    while (isspace(*c))
+        ++c;
+
+    return *c == '\0';
+}
+
+bool SqlExecuteBatch(SqlConnection* conn, SqlOperation* const* ops, size_t count, bool stopOnError)
+{
+    bool success = true;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool result = false;
+        size_t const merged = ops[i]->ExecuteCoalesced(conn, ops + i + 1, count - i - 1, result);
+
+        // outside of transactions one bad row must not discard the others, retry them one by one
+        if (!result && merged && !stopOnError)
+        {
+            result = true;
+            for (size_t j = i; j <= i + merged; ++j)
+                if (!ops[j]->Execute(conn))
+                    result = false;
+        }
+
+        i += merged;
+
+        if (!result)
+        {
+            success = false;
+            if (stopOnError)
+                break;
+        }
+    }
+
+    return success;
+}
+
 bool SqlPlainRequest::Execute(SqlConnection* conn)
 {
     /// just do it
@@ -34,6 +139,47 @@ bool SqlPlainRequest::Execute(SqlConnection* conn)
     return conn->Execute(m_sql);
 }
 
+size_t SqlPlainRequest::ExecuteCoalesced(SqlConnection* conn, SqlOperation* const* next, size_t count, bool& result)
+{
+    size_t valuesBegin, valuesEnd;
+    if (!count || !SqlSplitInsertValues(m_sql, valuesBegin, valuesEnd))
+    {
+        result = Execute(conn);
+        return 0;
+    }
+
+    std::string sql(m_sql, valuesEnd);
+    size_t merged = 0;
+
+    for (; merged < count && merged + 1 < SQL_COALESCE_MAX_ROWS; ++merged)
+    {
+        SqlPlainRequest const* other = dynamic_cast<SqlPlainRequest const*>(next[merged]);
+        if (!other)
+            break;
+
+        // same text up to the row list means same table and same columns
+        size_t otherBegin, otherEnd;
+        if (strncmp(m_sql, other->m_sql, valuesBegin) != 0 || !SqlSplitInsertValues(other->m_sql, otherBegin, otherEnd) || otherBegin != valuesBegin)
+            break;
+
+        if (sql.size() + 2 + (otherEnd - otherBegin) >= MAX_QUERY_LEN)
+            break;
+
+        sql.append(", ");
+        sql.append(other->m_sql + otherBegin, otherEnd - otherBegin);
+    }
+
+    if (!merged)
+    {
+        result = Execute(conn);
+        return 0;
+    }
+
+    LOCK_DB_CONN(conn);
+    result = conn->Execute(sql.c_str());
+    return merged;
+}
+
 SqlTransaction::~SqlTransaction()
 {
     while (!m_queue.empty())
@@ -52,19 +198,42 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
     conn->BeginTransaction();
 
-    const int nItems = m_queue.size();
-    for (int i = 0; i < nItems; ++i)
+    if (!SqlExecuteBatch(conn, &m_queue[0], m_queue.size(), true))
     {
-        SqlOperation* pStmt = m_queue[i];
+        conn->RollbackTransaction();
+        if (m_failed)
+            *m_failed = true;
+        return false;
+    }
 
-        if (!pStmt->Execute(conn))
-        {
-            conn->RollbackTransaction();
-            return false;
-        }
+    if (!conn->CommitTransaction())
+    {
+        if (m_failed)
+            *m_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool SqlAsyncBarrier::Arrive(SqlConnection* conn)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (--m_waiting == 0)
+    {
+        // last thread executes the write and releases the others
+        bool result = m_operation->Execute(conn);
+        m_done = true;
+        m_condition.notify_all();
+        return result;
     }
 
-    return conn->CommitTransaction();
+    // threads left at shutdown are drained one after another, waiting would never end
+    while (!m_done && !m_db.IsAsyncDraining())
+        m_condition.wait_for(lock, std::chrono::milliseconds(10));
+
+    return true;
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
@@ -82,6 +251,44 @@ bool SqlPreparedRequest::Execute(SqlConnection* conn)
     return conn->ExecuteStmt(m_nIndex, *m_param);
 }
 
+size_t SqlPreparedRequest::ExecuteCoalesced(SqlConnection* conn, SqlOperation* const* next, size_t count, bool& result)
+{
+    size_t available = 0;
+    while (available < count && available + 1 < SQL_COALESCE_MAX_ROWS)
+    {
+        SqlPreparedRequest const* other = dynamic_cast<SqlPreparedRequest const*>(next[available]);
+        if (!other || other->m_nIndex != m_nIndex)
+            break;
+
+        ++available;
+    }
+
+    // a multi-row statement gets prepared for each row count, powers of two keep their number low
+    uint32 const rowParams = m_param->boundParams();
+    uint32 rows = 1;
+    while (rows * 2 <= available + 1 && rows * 2 * rowParams <= 0xFFFF)
+        rows *= 2;
+
+    int const nIndex = rows > 1 ? conn->DB().GetMultiRowStmtIndex(m_nIndex, rows) : -1;
+    if (nIndex == -1)
+    {
+        result = Execute(conn);
+        return 0;
+    }
+
+    SqlStmtParameters params(rowParams * rows);
+    for (auto const& param : m_param->params())
+        params.addParam(param);
+
+    for (uint32 i = 0; i < rows - 1; ++i)
+        for (auto const& param : static_cast<SqlPreparedRequest const*>(next[i])->m_param->params())
+            params.addParam(param);
+
+    LOCK_DB_CONN(conn);
+    result = conn->ExecuteStmt(nIndex, params);
+    return rows - 1;
+}
+
 /// ---- ASYNC QUERIES ----
 
 bool SqlQuery::Execute(SqlConnection* conn)
@@ -25,7 +25,9 @@
 #include <queue>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <memory>
+#include <atomic>
 
 /// ---- BASE ---
 
@@ -39,9 +41,27 @@ class SqlOperation
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // execute this request together with compatible requests directly following it as one statement
+        // returns the amount of requests from 'next' which were executed, the result of the execution is stored in 'result'
+        virtual size_t ExecuteCoalesced(SqlConnection* conn, SqlOperation* const* /*next*/, size_t /*count*/, bool& result)
+        {
+            result = Execute(conn);
+            return 0;
+        }
         virtual ~SqlOperation() {}
 };
 
+// maximal amount of rows merged into one multi-row insert
+#define SQL_COALESCE_MAX_ROWS 32
+
+// locate the row list of an 'INSERT INTO ... VALUES (...), (...)' or 'REPLACE INTO ...' statement
+// returns false for statements which can't be extended by more rows
+bool SqlSplitInsertValues(const char* sql, size_t& valuesBegin, size_t& valuesEnd);
+
+// execute requests in order, merging adjacent single-row inserts into the same table
+// with stopOnError the execution stops at the first failed request and false is returned
+bool SqlExecuteBatch(SqlConnection* conn, SqlOperation* const* ops, size_t count, bool stopOnError);
+
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
 class SqlPlainRequest : public SqlOperation
@@ -52,18 +72,21 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char* sql) : m_sql(mangos_strdup(sql)) {}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
+        size_t ExecuteCoalesced(SqlConnection* conn, SqlOperation* const* next, size_t count, bool& result) override;
 };
 
 class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        std::shared_ptr<std::atomic<bool> > m_failed;      // set when the transaction is rolled back
 
     public:
         SqlTransaction() {}
         ~SqlTransaction();
 
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        void SetFailedFlag(std::shared_ptr<std::atomic<bool> > const& failed) { m_failed = failed; }
 
         bool Execute(SqlConnection* conn) override;
 };
@@ -75,12 +98,40 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection* conn) override;
+        size_t ExecuteCoalesced(SqlConnection* conn, SqlOperation* const* next, size_t count, bool& result) override;
 
     private:
         const int m_nIndex;
         SqlStmtParameters* m_param;
 };
 
+// one write queued on all delay threads, executed when every thread reached it
+// the threads which reach it first wait, so requests queued before it on any thread are executed before it and later ones after it
+class SqlAsyncBarrier
+{
+    public:
+        SqlAsyncBarrier(Database& db, SqlOperation* op, uint32 threadCount) : m_db(db), m_operation(op), m_waiting(threadCount), m_done(false) {}
+
+        bool Arrive(SqlConnection* conn);
+
+    private:
+        Database& m_db;
+        std::unique_ptr<SqlOperation> m_operation;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        uint32 m_waiting;                                   // threads which did not reach the barrier yet
+        bool m_done;
+};
+
+class SqlBarrierRequest : public SqlOperation
+{
+    private:
+        std::shared_ptr<SqlAsyncBarrier> m_barrier;
+    public:
+        SqlBarrierRequest(std::shared_ptr<SqlAsyncBarrier> const& barrier) : m_barrier(barrier) {}
+        bool Execute(SqlConnection* conn) override { return m_barrier->Arrive(conn); }
+};
+
 /// ---- ASYNC QUERIES ----
 
 class SqlQuery;                                             /// contains a single async query
@@ -28,6 +28,7 @@
 #include <iostream>
 #include <thread>
 #include <cstdarg>
+#include <set>
 
 INSTANTIATE_SINGLETON_1(Log);
 
@@ -66,7 +67,9 @@ const int LogType_count = int(LogError) + 1;
 
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr),
-    dberLogfile(nullptr), eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    dberLogfile(nullptr), eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr),
+    m_asyncEnabled(false), m_asyncProducers(0), m_asyncStop(false), m_asyncWriterIdle(false), m_asyncDropped(0), m_asyncFlushInterval(0),
+    m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
 {
     Initialize();
 }
@@ -216,6 +219,8 @@ void Log::SetLogFileLevel(char* level)
 
 void Log::Initialize()
 {
+    stopAsyncWriter();
+
     /// Common log files data
     m_logsDir = sConfig.GetStringDefault("LogsDir");
     if (!m_logsDir.empty())
@@ -280,6 +285,8 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    startAsyncWriter();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -351,203 +358,291 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+// format once for all outputs of a message
+static std::string FormatLogMessage(char const* format, va_list ap)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    char buf[1024];
 
-    fflush(stdout);
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    int len = vsnprintf(buf, sizeof(buf), format, apCopy);
+    va_end(apCopy);
+
+    if (len < 0)
+        return std::string();
+
+    if (size_t(len) < sizeof(buf))
+        return std::string(buf, len);
+
+    std::string result(len + 1, '\0');
+    vsnprintf(&result[0], result.size(), format, ap);
+    result.resize(len);
+    return result;
 }
 
-void Log::outString(const char* str, ...)
+static void AppendTimestamp(std::string& str)
 {
-    if (!str)
-        return;
+    time_t t = time(nullptr);
+    tm* aTm = localtime(&t);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+    str.append(buf);
+}
+
+void Log::writeConsole(bool stdout_stream, Color const* color, std::string const& message)
+{
+    FILE* stream = stdout_stream ? stdout : stderr;
 
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
+    if (color && m_colored)
+        SetColor(stdout_stream, *color);
 
     if (m_includeTime)
         outTime();
 
-    va_list ap;
-
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+    if (!message.empty())
+        utf8printf(stream, "%s", message.c_str());
 
-    if (m_colored)
-        ResetColor(true);
+    if (color && m_colored)
+        ResetColor(stdout_stream);
 
-    printf("\n");
+    fprintf(stream, "\n");
+    fflush(stream);
+}
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
+void Log::writeFile(FILE* file, std::string const& text, bool timestamp)
+{
+    FileMessage message;
+    message.file = file;
+    if (timestamp)
+        AppendTimestamp(message.text);
+    message.text.append(text);
 
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+    writeFileMessage(message);
+}
 
-        fflush(logfile);
-    }
+void Log::writeGmlogPerAccount(uint32 account, std::string const& text)
+{
+    FileMessage message;
+    message.account = account;
+    AppendTimestamp(message.text);
+    message.text.append(text);
 
-    fflush(stdout);
+    writeFileMessage(message);
 }
 
-void Log::outError(const char* err, ...)
+void Log::writeFileMessage(FileMessage& message)
 {
-    if (!err)
+    // registered before the enabled check, stopAsyncWriter waits for us before the final drain
+    ++m_asyncProducers;
+    if (m_asyncEnabled)
+    {
+        if (!m_asyncQueue->Push(std::move(message)))
+            ++m_asyncDropped;
+        else if (m_asyncWriterIdle.load(std::memory_order_relaxed))
+            m_asyncWakeup.notify_one();
+        --m_asyncProducers;
         return;
+    }
+    --m_asyncProducers;
 
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    if (message.file)
+    {
+        fwrite(message.text.data(), 1, message.text.size(), message.file);
+        fflush(message.file);
+    }
+    else if (FILE* per_file = openGmlogPerAccount(message.account))
+    {
+        fwrite(message.text.data(), 1, message.text.size(), per_file);
+        fclose(per_file);
+    }
+}
 
-    if (m_includeTime)
-        outTime();
+void Log::startAsyncWriter()
+{
+    if (!sConfig.GetBoolDefault("LogAsync", false))
+        return;
 
-    va_list ap;
+    m_asyncFlushInterval = sConfig.GetIntDefault("LogFlushInterval", 0);
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+    uint32 queueSize = sConfig.GetIntDefault("LogAsyncQueueSize", 8192);
+    if (!m_asyncQueue || m_asyncQueue->Capacity() < queueSize)
+        m_asyncQueue.reset(new MPSCRingBuffer<FileMessage>(std::max(queueSize, 16u)));
 
-    if (m_colored)
-        ResetColor(false);
+    m_asyncStop = false;
+    m_asyncWriterIdle = false;
+    m_asyncWriter = std::thread(&Log::asyncWriterThread, this);
+    m_asyncEnabled = true;
+}
 
-    fprintf(stderr, "\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+void Log::stopAsyncWriter()
+{
+    if (!m_asyncWriter.joinable())
+        return;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    // new messages are written synchronously from now on
+    m_asyncEnabled = false;
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    // producers that already saw the writer enabled must finish their push first
+    while (m_asyncProducers)
+        std::this_thread::yield();
 
-    fflush(stderr);
+    m_asyncStop = true;
+    m_asyncWakeup.notify_one();
+    m_asyncWriter.join();
+
+    // messages pushed while the writer was stopping
+    FileMessage message;
+    while (m_asyncQueue->Pop(message))
+        writeFileMessage(message);
 }
 
-void Log::outErrorDb()
+void Log::asyncWriterThread()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    std::set<FILE*> unflushed;
+    std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+    uint64 reportedDropped = m_asyncDropped;
 
-    if (m_includeTime)
-        outTime();
+    for (;;)
+    {
+        bool stop = m_asyncStop;
+
+        uint32 written = 0;
+        FileMessage message;
+        while (m_asyncQueue->Pop(message))
+        {
+            if (message.file)
+            {
+                fwrite(message.text.data(), 1, message.text.size(), message.file);
+                unflushed.insert(message.file);
+            }
+            else if (FILE* per_file = openGmlogPerAccount(message.account))
+            {
+                fwrite(message.text.data(), 1, message.text.size(), per_file);
+                fclose(per_file);
+            }
+            ++written;
+        }
 
-    fprintf(stderr, "\n");
+        uint64 dropped = m_asyncDropped;
+        if (dropped != reportedDropped && logfile)
+        {
+            std::string text;
+            AppendTimestamp(text);
+            char buf[128];
+            snprintf(buf, sizeof(buf), "ERROR:Log queue full, " UI64FMTD " messages dropped\n", dropped - reportedDropped);
+            text.append(buf);
+            fwrite(text.data(), 1, text.size(), logfile);
+            unflushed.insert(logfile);
+            reportedDropped = dropped;
+        }
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!unflushed.empty() && (stop || !m_asyncFlushInterval ||
+                                   now - lastFlush >= std::chrono::milliseconds(m_asyncFlushInterval)))
+        {
+            for (std::set<FILE*>::const_iterator itr = unflushed.begin(); itr != unflushed.end(); ++itr)
+                fflush(*itr);
+            unflushed.clear();
+            lastFlush = now;
+        }
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        if (stop)
+            break;
+
+        if (!written)
+        {
+            // producers only notify an idle writer, a missed wakeup is covered by the timeout
+            std::unique_lock<std::mutex> lock(m_asyncWakeupMtx);
+            m_asyncWriterIdle = true;
+            m_asyncWakeup.wait_for(lock, std::chrono::milliseconds(m_asyncFlushInterval ? std::min(m_asyncFlushInterval, 100u) : 100u));
+            m_asyncWriterIdle = false;
+        }
     }
+}
+
+void Log::outString()
+{
+    writeConsole(true, nullptr, std::string());
 
-    fflush(stderr);
+    if (logfile)
+        writeFile(logfile, "\n");
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::outString(const char* str, ...)
 {
-    if (!err)
+    if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    writeConsole(true, &m_colors[LogNormal], message);
 
-    if (m_includeTime)
-        outTime();
+    if (logfile)
+        writeFile(logfile, message + "\n");
+}
 
-    va_list ap;
+void Log::outError(const char* err, ...)
+{
+    if (!err)
+        return;
 
+    va_list ap;
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    std::string message = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+    writeConsole(false, &m_colors[LogError], message);
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+        writeFile(logfile, "ERROR:" + message + "\n");
+}
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+void Log::outErrorDb()
+{
+    writeConsole(false, nullptr, std::string());
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    if (logfile)
+        writeFile(logfile, "ERROR:\n");
 
     if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
+        writeFile(dberLogfile, "\n");
+}
+
+void Log::outErrorDb(const char* err, ...)
+{
+    if (!err)
+        return;
+
+    va_list ap;
+    va_start(ap, err);
+    std::string message = FormatLogMessage(err, ap);
+    va_end(ap);
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+    writeConsole(false, &m_colors[LogError], message);
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+    if (logfile)
+        writeFile(logfile, "ERROR:" + message + "\n");
 
-    fflush(stderr);
+    if (dberLogfile)
+        writeFile(dberLogfile, message + "\n");
 }
 
 void Log::outErrorEventAI()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    writeConsole(false, nullptr, std::string());
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+        writeFile(logfile, "ERROR CreatureEventAI\n");
 
     if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
-
-    fflush(stderr);
+        writeFile(eventAiErLogfile, "\n");
 }
 
 void Log::outErrorEventAI(const char* err, ...)
@@ -555,51 +650,18 @@ void Log::outErrorEventAI(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    std::string message = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+    writeConsole(false, &m_colors[LogError], message);
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+        writeFile(logfile, "ERROR CreatureEventAI: " + message + "\n");
 
     if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
-
-    fflush(stderr);
+        writeFile(eventAiErLogfile, message + "\n");
 }
 
 void Log::outBasic(const char* str, ...)
@@ -607,38 +669,21 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
+    bool toConsole = m_logLevel >= LOG_LVL_BASIC;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_BASIC;
+    if (!toConsole && !toFile)
+        return;
 
-        printf("\n");
-    }
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+    if (toConsole)
+        writeConsole(true, &m_colors[LogDetails], message);
 
-    fflush(stdout);
+    if (toFile)
+        writeFile(logfile, message + "\n");
 }
 
 void Log::outDetail(const char* str, ...)
@@ -646,40 +691,21 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
+    bool toConsole = m_logLevel >= LOG_LVL_DETAIL;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_DETAIL;
+    if (!toConsole && !toFile)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    if (toConsole)
+        writeConsole(true, &m_colors[LogDetails], message);
 
-    fflush(stdout);
+    if (toFile)
+        writeFile(logfile, message + "\n");
 }
 
 void Log::outDebug(const char* str, ...)
@@ -687,40 +713,21 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
-    {
-        outTimestamp(logfile);
+    bool toConsole = m_logLevel >= LOG_LVL_DEBUG;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_DEBUG;
+    if (!toConsole && !toFile)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    if (toConsole)
+        writeConsole(true, &m_colors[LogDebug], message);
 
-    fflush(stdout);
+    if (toFile)
+        writeFile(logfile, message + "\n");
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -728,109 +735,52 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        if (m_colored)
-            ResetColor(true);
+    if (m_logLevel >= LOG_LVL_DETAIL)
+        writeConsole(true, &m_colors[LogDetails], message);
 
-        printf("\n");
-    }
+    message.append("\n");
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+        writeFile(logfile, message);
 
     if (m_gmlog_per_account)
-    {
-        if (FILE* per_file = openGmlogPerAccount(account))
-        {
-            va_list ap;
-            outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
-            fclose(per_file);
-        }
-    }
+        writeGmlogPerAccount(account, message);
     else if (gmLogfile)
-    {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
-    }
-
-    fflush(stdout);
+        writeFile(gmLogfile, message);
 }
 
 void Log::outChar(const char* str, ...)
 {
-
-    if (!str)
+    if (!str || !charLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
+
+    writeFile(charLogfile, message + "\n");
 }
 
 void Log::outErrorScriptLib()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    writeConsole(false, nullptr, std::string());
 
     if (logfile)
     {
-        outTimestamp(logfile);
         if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
+            writeFile(logfile, std::string("<") + m_scriptLibName + " ERROR:> ");
         else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
+            writeFile(logfile, "<Scripting Library ERROR>: ");
     }
 
     if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+        writeFile(scriptErrLogFile, "\n");
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -838,54 +788,23 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    std::string message = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+    writeConsole(false, &m_colors[LogError], message);
 
     if (logfile)
     {
-        outTimestamp(logfile);
         if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
+            writeFile(logfile, std::string("<") + m_scriptLibName + " ERROR>: " + message + "\n");
         else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+            writeFile(logfile, "<Scripting Library ERROR>: " + message + "\n");
     }
 
     if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+        writeFile(scriptErrLogFile, message + "\n");
 }
 
 void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
@@ -893,56 +812,55 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
 
-    outTimestamp(worldLogfile);
+    std::string text(buf);
+    text.reserve(text.size() + packet.size() * 3 + packet.size() / 16 + 3);
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    static char const hexDigits[] = "0123456789ABCDEF";
 
     size_t p = 0;
     while (p < packet.size())
     {
         for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+        {
+            uint8 value = packet[p++];
+            text.push_back(hexDigits[value >> 4]);
+            text.push_back(hexDigits[value & 0x0F]);
+            text.push_back(' ');
+        }
 
-        fprintf(worldLogfile, "\n");
+        text.push_back('\n');
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    text.append("\n\n");
+    writeFile(worldLogfile, text);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!charLogfile)
+        return;
 
-    if (charLogfile)
-    {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
-    }
+    char buf[256];
+    snprintf(buf, sizeof(buf), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+    writeFile(charLogfile, std::string(buf) + str + "\n== END DUMP ==\n", false);
 }
 
 void Log::outRALog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !raLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    std::string message = FormatLogMessage(str, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    writeFile(raLogfile, message + "\n");
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -972,18 +890,25 @@ void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
     m_scriptLibName = libName;
 
+    // queued messages may still refer to the old file
+    bool async = m_asyncWriter.joinable();
+    if (async)
+        stopAsyncWriter();
+
     if (scriptErrLogFile)
         fclose(scriptErrLogFile);
 
     if (!fname)
-    {
         scriptErrLogFile = nullptr;
-        return;
+    else
+    {
+        std::string fileName = m_logsDir;
+        fileName.append(fname);
+        scriptErrLogFile = fopen(fileName.c_str(), "a");
     }
 
-    std::string fileName = m_logsDir;
-    fileName.append(fname);
-    scriptErrLogFile = fopen(fileName.c_str(), "a");
+    if (async)
+        startAsyncWriter();
 }
 
 void outstring_log()
@@ -21,8 +21,12 @@
 
 #include "Common.h"
 #include "Policies/Singleton.h"
+#include "Utilities/MPSCRingBuffer.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 class Config;
 class ByteBuffer;
@@ -98,6 +102,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            stopAsyncWriter();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -178,6 +184,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        std::string const& GetLogsDir() const { return m_logsDir; }
 
         static void WaitBeforeContinueIfNeed();
 
@@ -185,9 +192,28 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         void setScriptLibraryErrorFile(char const* fname, char const* libName);
 
     private:
+        // file output queued for the writer thread
+        struct FileMessage
+        {
+            FileMessage() : file(nullptr), account(0) {}
+
+            FILE* file;                                     // nullptr for per account gm log
+            uint32 account;
+            std::string text;
+        };
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        void writeConsole(bool stdout_stream, Color const* color, std::string const& message);
+        void writeFile(FILE* file, std::string const& text, bool timestamp = true);
+        void writeGmlogPerAccount(uint32 account, std::string const& text);
+        void writeFileMessage(FileMessage& message);
+
+        void startAsyncWriter();
+        void stopAsyncWriter();
+        void asyncWriterThread();
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -198,6 +224,18 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* worldLogfile;
         std::mutex m_worldLogMtx;
 
+        // asynchronous file output, console output stays synchronous
+        std::atomic<bool> m_asyncEnabled;
+        std::atomic<uint32> m_asyncProducers;               // threads between the enabled check and the push
+        std::unique_ptr<MPSCRingBuffer<FileMessage> > m_asyncQueue;
+        std::thread m_asyncWriter;
+        std::atomic<bool> m_asyncStop;
+        std::atomic<bool> m_asyncWriterIdle;
+        std::mutex m_asyncWakeupMtx;
+        std::condition_variable m_asyncWakeup;
+        std::atomic<uint64> m_asyncDropped;                 // messages lost on full queue
+        uint32 m_asyncFlushInterval;                        // ms between flushes, 0 after every batch
+
         // log/console control
         LogLevel m_logLevel;
         LogLevel m_logFileLevel;
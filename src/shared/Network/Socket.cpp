@@ -33,7 +33,7 @@ namespace MaNGOS
 {
 Socket::Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler)
     : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(service),
-      m_closeHandler(closeHandler), m_outBufferFlushTimer(service), m_address("0.0.0.0") {}
+      m_closeHandler(closeHandler), m_service(service), m_outBufferFlushTimer(service), m_address("0.0.0.0") {}
 
 bool Socket::Open()
 {
@@ -162,33 +162,60 @@ bool Socket::Read(char *buffer, int length)
     return true;
 }
 
-void Socket::Write(const char *header, int headerSize, const char* content, int contentSize)
+// note that this function assumes that the socket mutex is locked
+void Socket::BufferOut(const char *buffer, int length)
 {
-    std::lock_guard<std::mutex> guard(m_mutex);
-
     // get the correct buffer depending on the current writing state
     PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+    OutChunkQueue& chunks = GetOutChunks();
+
+    // extend the last chunk if it ends where this data is written
+    if (!chunks.empty() && !chunks.back().content && chunks.back().offset + chunks.back().length == outBuffer->m_writePosition)
+        chunks.back().length += length;
+    else
+        chunks.push_back({ nullptr, outBuffer->m_writePosition, size_t(length) });
+
+    outBuffer->Write(buffer, length);
+}
+
+void Socket::Write(const char *header, int headerSize, const char* content, int contentSize)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
 
     // write the header
-    outBuffer->Write(header, headerSize);
+    BufferOut(header, headerSize);
 
     // write the content
-    outBuffer->Write(content, contentSize);
+    BufferOut(content, contentSize);
 
     // flush data if need
     if (m_writeState == WriteState::Idle)
         StartWriteFlushTimer();
 }
 
-void Socket::Write(const char *buffer, int length)
+void Socket::Write(const char *header, int headerSize, const std::shared_ptr<const uint8>& content, int contentSize)
 {
     std::lock_guard<std::mutex> guard(m_mutex);
 
-    // get the correct buffer depending on the current writing state
-    PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
-
     // write the header
-    outBuffer->Write(buffer, length);
+    BufferOut(header, headerSize);
+
+    // queue a reference to the content, small content is just copied
+    if (contentSize < SharedContentMinSize)
+        BufferOut(reinterpret_cast<const char *>(content.get()), contentSize);
+    else
+        GetOutChunks().push_back({ content, 0, size_t(contentSize) });
+
+    // flush data if need
+    if (m_writeState == WriteState::Idle)
+        StartWriteFlushTimer();
+}
+
+void Socket::Write(const char *buffer, int length)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    BufferOut(buffer, length);
 
     // flush data if need
     if (m_writeState == WriteState::Idle)
@@ -231,8 +258,22 @@ void Socket::FlushOut()
     // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
     m_writeState = WriteState::Sending;
 
+    StartAsyncWrite();
+}
+
+// note that this function assumes that the socket mutex is locked and there is data to send
+void Socket::StartAsyncWrite()
+{
+    // gather the queued chunks to one scatter/gather write, data of the out buffer does not move until it completes
+    m_sendBuffers.clear();
+    for (OutChunkQueue::const_iterator itr = m_outChunks.begin(); itr != m_outChunks.end() && m_sendBuffers.size() < MaxSendBuffers; ++itr)
+    {
+        const uint8* data = itr->content ? itr->content.get() : &m_outBuffer->m_buffer[0];
+        m_sendBuffers.push_back(boost::asio::buffer(data + itr->offset, itr->length));
+    }
+
     std::shared_ptr<Socket> ptr = shared<Socket>();
-    m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
+    m_socket.async_write_some(m_sendBuffers,
         make_custom_alloc_handler(m_allocator,
             [ptr](const boost::system::error_code &error, size_t length) { ptr->OnWriteComplete(error, length); }));
 }
@@ -264,37 +305,72 @@ void Socket::OnWriteComplete(const boost::system::error_code &error, size_t leng
     std::lock_guard<std::mutex> guard(m_mutex);
 
     assert(m_writeState == WriteState::Sending);
-    assert(length <= m_outBuffer->m_writePosition);
 
-    // if there is data left to write, move it to the start of the buffer
-    if (length < m_outBuffer->m_writePosition)
+    // drop the sent chunks, the first remaining one may be sent partially
+    while (length > 0)
     {
-        memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-        m_outBuffer->m_writePosition -= length;
+        assert(!m_outChunks.empty());
+
+        OutChunk& chunk = m_outChunks.front();
+        if (length < chunk.length)
+        {
+            chunk.offset += length;
+            chunk.length -= length;
+            break;
+        }
+
+        length -= chunk.length;
+        m_outChunks.pop_front();
     }
-    // if not, reset the write pointer
-    else
+
+    // move the remaining data of the out buffer to its start, chunks of the out buffer are in buffer order
+    OutChunkQueue::iterator firstOwned = m_outChunks.begin();
+    while (firstOwned != m_outChunks.end() && firstOwned->content)
+        ++firstOwned;
+
+    if (firstOwned == m_outChunks.end())
         m_outBuffer->m_writePosition = 0;
+    else if (const size_t sent = firstOwned->offset)
+    {
+        memmove(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[sent]), (m_outBuffer->m_writePosition - sent) * sizeof(m_outBuffer->m_buffer[0]));
+        m_outBuffer->m_writePosition -= sent;
+
+        for (OutChunkQueue::iterator itr = firstOwned; itr != m_outChunks.end(); ++itr)
+            if (!itr->content)
+                itr->offset -= sent;
+    }
 
     // if there is data in the secondary buffer, append it to the primary buffer
-    if (m_secondaryOutBuffer->m_writePosition > 0)
+    if (!m_secondaryOutChunks.empty())
     {
-        // do we have enough space? if not, resize
-        if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-            m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+        const size_t base = m_outBuffer->m_writePosition;
 
-        memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
+        if (m_secondaryOutBuffer->m_writePosition > 0)
+        {
+            // do we have enough space? if not, resize
+            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
+                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+
+            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
 
-        m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-        m_secondaryOutBuffer->m_writePosition = 0;
+            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
+            m_secondaryOutBuffer->m_writePosition = 0;
+        }
+
+        for (OutChunkQueue::iterator itr = m_secondaryOutChunks.begin(); itr != m_secondaryOutChunks.end(); ++itr)
+        {
+            if (!itr->content)
+                itr->offset += base;
+
+            m_outChunks.push_back(std::move(*itr));
+        }
+
+        m_secondaryOutChunks.clear();
     }
 
-    std::shared_ptr<Socket> ptr = shared<Socket>();
     // if there is any data to write, do so immediately
-    if (m_outBuffer->m_writePosition > 0)
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-            make_custom_alloc_handler(m_allocator,
-                [ptr](const boost::system::error_code &error, size_t length) { ptr->OnWriteComplete(error, length);}));
+    if (!m_outChunks.empty())
+        StartAsyncWrite();
     else
         m_writeState = WriteState::Idle;
 }
@@ -25,9 +25,11 @@
 
 #include <boost/asio.hpp>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <functional>
 
 namespace MaNGOS
@@ -39,6 +41,9 @@ namespace MaNGOS
             // ingame but increase bandwidth efficiency by reducing tcp overhead.
             static const int BufferTimeout = 50;
 
+            // maximum number of buffers handed over to one scatter/gather write
+            static const size_t MaxSendBuffers = 64;
+
             enum class WriteState
             {
                 Idle,       // no write operation is currently underway
@@ -59,17 +64,37 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // one part of the outgoing data, either a range of its out buffer or shared content referenced by many sockets
+            struct OutChunk
+            {
+                std::shared_ptr<const uint8> content;   // nullptr for data in the out buffer
+                size_t offset;                          // offset in the out buffer or in the shared content
+                size_t length;
+            };
+
+            typedef std::deque<OutChunk> OutChunkQueue;
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
             std::unique_ptr<PacketBuffer> m_outBuffer;
             std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
 
+            // outgoing data in send order, m_outChunks is sent while m_secondaryOutChunks collects new writes
+            OutChunkQueue m_outChunks;
+            OutChunkQueue m_secondaryOutChunks;
+            std::vector<boost::asio::const_buffer> m_sendBuffers;
+
             std::mutex m_mutex;
+            boost::asio::io_service &m_service;
             boost::asio::deadline_timer m_outBufferFlushTimer;
 
             void StartAsyncRead();
             void OnRead(const boost::system::error_code &error, size_t length);
 
+            void BufferOut(const char *buffer, int length);
+            OutChunkQueue& GetOutChunks() { return m_writeState == WriteState::Sending ? m_secondaryOutChunks : m_outChunks; }
+
             void StartWriteFlushTimer();
+            void StartAsyncWrite();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
 
@@ -87,7 +112,14 @@ namespace MaNGOS
 
             void ForceFlushOut();
 
+            // run handler in the network thread of this socket, handlers are executed in the order they are posted
+            template <typename Handler>
+            void PostToNetworkThread(Handler handler) { m_service.post(handler); }
+
         public:
+            // shared content smaller than this is copied to the out buffer, an own iovec entry would cost more than the copy
+            static const int SharedContentMinSize = 128;
+
             Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
             virtual ~Socket() = default;
 
@@ -102,6 +134,8 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            // content is not copied but referenced until it is sent, it must not change anymore
+            void Write(const char *header, int headerSize, const std::shared_ptr<const uint8>& content, int contentSize);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
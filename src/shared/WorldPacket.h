@@ -21,11 +21,14 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include "Utilities/MPSCQueue.h"
 #include "Server/Opcodes.h"
 
+#include <memory>
+
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
-class WorldPacket : public ByteBuffer
+class WorldPacket : public ByteBuffer, public MPSCQueueNode
 {
     public:
         // just container for later use
@@ -34,7 +37,7 @@ class WorldPacket : public ByteBuffer
         }
         explicit WorldPacket(uint16 opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode) { }
         // copy constructor
-        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
+        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), MPSCQueueNode(), m_opcode(packet.m_opcode)
         {
         }
 
@@ -49,7 +52,53 @@ class WorldPacket : public ByteBuffer
         void SetOpcode(uint16 opcode) { m_opcode = opcode; }
         inline const char* GetOpcodeName() const { return LookupOpcodeName(m_opcode); }
 
+        // immutable copy shared by all receivers while a SharedPacketGuard exists, otherwise nullptr
+        std::shared_ptr<WorldPacket const> GetShared() const;
+
     protected:
         uint16 m_opcode;
+
+    private:
+        friend class SharedPacketGuard;
+
+        // never copied together with the packet content
+        struct SharedState
+        {
+            SharedState() : enabled(false) {}
+            SharedState(SharedState const&) : enabled(false) {}
+            SharedState& operator=(SharedState const&) { return *this; }
+
+            bool enabled;
+            std::shared_ptr<WorldPacket const> packet;
+        };
+
+        mutable SharedState m_shared;
+};
+
+/// Lets all sockets reference one copy of a broadcasted packet instead of copying the content to each
+/// out buffer. The copy is created on the first send, the packet must not change while the guard exists.
+class SharedPacketGuard
+{
+    public:
+        explicit SharedPacketGuard(WorldPacket const& packet) : m_packet(packet), m_owner(!packet.m_shared.enabled)
+        {
+            m_packet.m_shared.enabled = true;
+        }
+
+        ~SharedPacketGuard()
+        {
+            if (!m_owner)
+                return;
+
+            m_packet.m_shared.enabled = false;
+            m_packet.m_shared.packet.reset();
+        }
+
+        SharedPacketGuard(SharedPacketGuard const&) = delete;
+        SharedPacketGuard& operator=(SharedPacketGuard const&) = delete;
+
+    private:
+        WorldPacket const& m_packet;
+        bool m_owner;                                       // false for nested guards of the same packet
 };
 #endif
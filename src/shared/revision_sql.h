@@ -2,5 +2,5 @@
 #define __REVISION_SQL_H__
  #define REVISION_DB_REALMD "required_z2716_01_realmd_totp"
  #define REVISION_DB_CHARACTERS "required_z2708_01_characters_account_instances_entered"
- #define REVISION_DB_MANGOS "required_z2717_01_mangos_spam_records_length"
+ #define REVISION_DB_MANGOS "required_z2718_01_mangos_command"
 #endif // __REVISION_SQL_H__